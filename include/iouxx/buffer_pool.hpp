@@ -0,0 +1,373 @@
+#pragma once
+#ifndef IOUXX_BUFFER_POOL_H
+#define IOUXX_BUFFER_POOL_H 1
+
+/*
+    * Buffer pools owning their memory, built on top of ring registrations.
+*/
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <sys/mman.h>
+
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <system_error>
+#include <utility>
+
+#include "macro_config.hpp"
+#include "cxxmodule_helper.hpp"
+#include "iouringxx.hpp"
+#include "util/utility.hpp"
+#include "util/assertion.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+namespace iouxx::details {
+
+    // Anonymous mapping, backed by huge pages if requested and available.
+    class slab_memory
+    {
+    public:
+        slab_memory() = default;
+        slab_memory(const slab_memory&) = delete;
+        slab_memory& operator=(const slab_memory&) = delete;
+
+        ~slab_memory() {
+            reset();
+        }
+
+        std::error_code map(std::size_t size, bool huge) noexcept {
+            IOUXX_ASSERT(addr == nullptr);
+            constexpr int prot = PROT_READ | PROT_WRITE;
+            constexpr int flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE;
+            if (huge) {
+                // Explicit huge pages need a reserved pool, rounded up to 2MiB
+                const std::size_t huge_size = (size + huge_page_size - 1) & ~(huge_page_size - 1);
+                void* p = ::mmap(nullptr, huge_size, prot, flags | MAP_HUGETLB, -1, 0);
+                if (p != MAP_FAILED) {
+                    addr = p;
+                    len = huge_size;
+                    hugetlb = true;
+                    return std::error_code();
+                }
+            }
+            void* p = ::mmap(nullptr, size, prot, flags, -1, 0);
+            if (p == MAP_FAILED) {
+                return utility::make_system_error_code(errno);
+            }
+            if (huge) {
+                // Fall back to transparent huge pages, best effort
+                ::madvise(p, size, MADV_HUGEPAGE);
+            }
+            addr = p;
+            len = size;
+            hugetlb = false;
+            return std::error_code();
+        }
+
+        void reset() noexcept {
+            if (addr) {
+                ::munmap(addr, len);
+                addr = nullptr;
+                len = 0;
+                hugetlb = false;
+            }
+        }
+
+        std::byte* data() const noexcept {
+            return static_cast<std::byte*>(addr);
+        }
+
+        bool huge_pages() const noexcept {
+            return hugetlb;
+        }
+
+    private:
+        static constexpr std::size_t huge_page_size = std::size_t(2) << 20;
+
+        void* addr = nullptr;
+        std::size_t len = 0;
+        bool hugetlb = false;
+    };
+
+    // Slots and memory of a fixed_buffer_pool, heap allocated so that
+    // leases still out on reset can keep them alive.
+    struct fixed_buffer_storage
+    {
+        fixed_buffer_slots slots;
+        slab_memory slab;
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Provided buffer ring owning a slab of equal-sized buffers.
+    // All buffers are inserted on init, buffers selected by kernel are
+    // handed out as provided_buffer leases, and given back on their
+    // destruction, published to kernel in batches (see recycle_batch()).
+    // Note: the pool is pinned, and the ring must outlive it. Leases must
+    //  not outlive the pool.
+    class provided_buffer_pool
+    {
+    public:
+        provided_buffer_pool() = default;
+
+        // count must be a power of 2, at most 32768,
+        // and buffer_size must fit in 32 bits.
+        explicit provided_buffer_pool(iouxx::ring& ring, std::uint16_t bgid,
+            std::uint16_t count, std::size_t buffer_size, bool huge_pages = true,
+            bool incremental = false) {
+            std::error_code ec = init(ring, bgid, count, buffer_size, huge_pages, incremental);
+            if (ec) {
+                throw std::system_error(ec, "Failed to create provided buffer pool");
+            }
+        }
+
+        provided_buffer_pool(const provided_buffer_pool&) = delete;
+        provided_buffer_pool& operator=(const provided_buffer_pool&) = delete;
+        provided_buffer_pool(provided_buffer_pool&&) = delete;
+        provided_buffer_pool& operator=(provided_buffer_pool&&) = delete;
+
+        ~provided_buffer_pool() { reset(); }
+
+        // Map the slab, register buffer group bgid and insert all buffers.
+        // With incremental, buffers are consumed in chunks (IOU_PBUF_RING_INC),
+        // so large buffers are not wasted on small transfers.
+        std::error_code init(iouxx::ring& ring, std::uint16_t bgid,
+            std::uint16_t count, std::size_t buffer_size, bool huge_pages = true,
+            bool incremental = false) noexcept {
+            IOUXX_ASSERT(!valid());
+            if (!std::has_single_bit(count) || count > 32768 || buffer_size == 0
+                || buffer_size > std::numeric_limits<std::size_t>::max() / count
+                // Length of a buffer ring entry is 32 bits
+                || buffer_size > std::numeric_limits<std::uint32_t>::max()) {
+                return std::make_error_code(std::errc::invalid_argument);
+            }
+            if (std::error_code ec = slab.map(count * buffer_size, huge_pages)) {
+                return ec;
+            }
+            auto group = ring.register_buffer_group(count, bgid, incremental);
+            if (!group) {
+                slab.reset();
+                return group.error();
+            }
+            for (std::uint16_t bid = 0; bid < count; ++bid) {
+                group->insert(std::span(slab.data() + bid * buffer_size, buffer_size), bid);
+            }
+            ring_ptr = &ring;
+            buffers = *group;
+            buffer_count = count;
+            buffer_len = buffer_size;
+            return std::error_code();
+        }
+
+        // Unregister the group and unmap the slab.
+        void reset() noexcept {
+            if (valid()) {
+                ring_ptr->unregister_buffer_group(buffers.id());
+                ring_ptr = nullptr;
+                buffers = ring::buffer_group();
+                slab.reset();
+                buffer_count = 0;
+                buffer_len = 0;
+            }
+        }
+
+        bool valid() const noexcept {
+            return ring_ptr != nullptr;
+        }
+
+        // Pass to buffer select operations.
+        ring::buffer_group group() const noexcept {
+            return buffers;
+        }
+
+        std::uint16_t id() const noexcept {
+            return buffers.id();
+        }
+
+        std::uint16_t size() const noexcept {
+            return buffer_count;
+        }
+
+        std::size_t buffer_size() const noexcept {
+            return buffer_len;
+        }
+
+        // Whether the slab is backed by explicit huge pages (MAP_HUGETLB).
+        bool huge_pages() const noexcept {
+            return slab.huge_pages();
+        }
+
+        void recycle_batch(std::uint32_t n) noexcept {
+            buffers.recycle_batch(n);
+        }
+
+        void low_watermark(std::uint32_t n) noexcept {
+            buffers.low_watermark(n);
+        }
+
+        void commit() noexcept {
+            buffers.commit();
+        }
+
+        ring::buffer_group_stats stats() const noexcept {
+            return buffers.stats();
+        }
+
+    private:
+        details::slab_memory slab;
+        iouxx::ring* ring_ptr = nullptr;
+        ring::buffer_group buffers;
+        std::uint16_t buffer_count = 0;
+        std::size_t buffer_len = 0;
+    };
+
+    // Registered buffer table owning a slab of equal-sized buffers.
+    // Buffers are handed out as fixed_buffer leases carrying their index,
+    // for READ_FIXED/WRITE_FIXED and fixed buffer sends, and given back
+    // on destruction of the lease.
+    // Note: the pool is pinned, and the ring must outlive it. It takes the
+    //  whole buffer table of the ring, so the ring must not have one yet.
+    //  Leases still out on reset keep the slab mapped until the last of
+    //  them is destroyed.
+    class fixed_buffer_pool
+    {
+    public:
+        // Limit of registered buffers (IORING_MAX_REG_BUFFERS)
+        static constexpr std::uint16_t max_buffers = 16384;
+
+        fixed_buffer_pool() = default;
+
+        explicit fixed_buffer_pool(iouxx::ring& ring, std::uint16_t count,
+            std::size_t buffer_size, bool huge_pages = true) {
+            std::error_code ec = init(ring, count, buffer_size, huge_pages);
+            if (ec) {
+                throw std::system_error(ec, "Failed to create fixed buffer pool");
+            }
+        }
+
+        fixed_buffer_pool(const fixed_buffer_pool&) = delete;
+        fixed_buffer_pool& operator=(const fixed_buffer_pool&) = delete;
+        fixed_buffer_pool(fixed_buffer_pool&&) = delete;
+        fixed_buffer_pool& operator=(fixed_buffer_pool&&) = delete;
+
+        ~fixed_buffer_pool() { reset(); }
+
+        // Map the slab and register all buffers as the ring's buffer table,
+        // buffer of index i is the i-th slice of the slab.
+        // Registered memory counts towards RLIMIT_MEMLOCK.
+        std::error_code init(iouxx::ring& ring, std::uint16_t count,
+            std::size_t buffer_size, bool huge_pages = true) noexcept {
+            IOUXX_ASSERT(!valid());
+            // Each registered buffer is at most 1GiB
+            if (count == 0 || count > max_buffers || buffer_size == 0
+                || buffer_size > (std::size_t(1) << 30)) {
+                return std::make_error_code(std::errc::invalid_argument);
+            }
+            std::unique_ptr<details::fixed_buffer_storage> mem;
+            try {
+                mem = std::make_unique<details::fixed_buffer_storage>();
+            } catch (...) {
+                return std::make_error_code(std::errc::not_enough_memory);
+            }
+            if (std::error_code ec = mem->slab.map(count * buffer_size, huge_pages)) {
+                return ec;
+            }
+            if (std::error_code ec = mem->slots.init(count)) {
+                return ec;
+            }
+            std::byte* base = mem->slab.data();
+            if (std::error_code ec = ring.register_buffers(
+                std::views::iota(std::size_t(0), std::size_t(count))
+                    | std::views::transform([base, buffer_size](std::size_t i) noexcept {
+                        return std::span(base + i * buffer_size, buffer_size);
+                    }))) {
+                return ec;
+            }
+            storage = std::move(mem);
+            ring_ptr = &ring;
+            buffer_count = count;
+            buffer_len = buffer_size;
+            return std::error_code();
+        }
+
+        // Unregister the buffer table and unmap the slab,
+        // or leave it to the last lease still out.
+        void reset() noexcept {
+            if (valid()) {
+                ring_ptr->unregister_buffer_table();
+                ring_ptr = nullptr;
+                if (storage->slots.available() == buffer_count) {
+                    storage.reset();
+                } else {
+                    storage->slots.orphan(&destroy_storage, storage.release());
+                }
+                buffer_count = 0;
+                buffer_len = 0;
+            }
+        }
+
+        bool valid() const noexcept {
+            return ring_ptr != nullptr;
+        }
+
+        // Lease a free buffer, fails with no_buffer_space if all are leased.
+        std::expected<fixed_buffer, std::error_code> acquire() noexcept {
+            IOUXX_ASSERT(valid());
+            const int index = storage->slots.acquire();
+            if (index < 0) {
+                return utility::fail(std::errc::no_buffer_space);
+            }
+            return fixed_buffer(storage->slots, buffer(static_cast<std::uint16_t>(index)),
+                static_cast<std::uint16_t>(index));
+        }
+
+        // Memory of buffer with given index.
+        std::span<std::byte> buffer(std::uint16_t index) const noexcept {
+            IOUXX_ASSERT(index < buffer_count);
+            return std::span(storage->slab.data() + index * buffer_len, buffer_len);
+        }
+
+        std::uint16_t size() const noexcept {
+            return buffer_count;
+        }
+
+        std::size_t buffer_size() const noexcept {
+            return buffer_len;
+        }
+
+        // Buffers not leased.
+        std::uint16_t available() const noexcept {
+            return storage ? storage->slots.available() : 0;
+        }
+
+        // Whether the slab is backed by explicit huge pages (MAP_HUGETLB).
+        bool huge_pages() const noexcept {
+            return storage && storage->slab.huge_pages();
+        }
+
+    private:
+        static void destroy_storage(void* p) noexcept {
+            delete static_cast<details::fixed_buffer_storage*>(p);
+        }
+
+        std::unique_ptr<details::fixed_buffer_storage> storage;
+        iouxx::ring* ring_ptr = nullptr;
+        std::uint16_t buffer_count = 0;
+        std::size_t buffer_len = 0;
+    };
+
+} // namespace iouxx
+
+#endif // IOUXX_BUFFER_POOL_H
@@ -0,0 +1,271 @@
+#pragma once
+#ifndef IOUXX_EXECUTION_H
+#define IOUXX_EXECUTION_H 1
+
+/*
+    * std::execution (P2300) integration, only available if the standard
+    * library provides senders (__cpp_lib_senders).
+*/
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <version>
+
+#ifdef __cpp_lib_senders
+
+#include <concepts>
+#include <execution>
+#include <expected>
+#include <functional>
+#include <optional>
+#include <stop_token>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "macro_config.hpp"
+#include "cxxmodule_helper.hpp"
+#include "iouringxx.hpp"
+#include "iouops/noop.hpp"
+#include "util/utility.hpp"
+
+#endif // __cpp_lib_senders
+
+#endif // IOUXX_USE_CXX_MODULE
+
+#ifdef __cpp_lib_senders
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Forward declaration
+    class ring_scheduler;
+
+} // namespace iouxx
+
+namespace iouxx::details {
+
+    template<typename Result>
+    struct sender_value_signature {
+        using type = std::execution::set_value_t(Result);
+    };
+
+    template<>
+    struct sender_value_signature<void> {
+        using type = std::execution::set_value_t();
+    };
+
+    // Environment of ring senders, their values are delivered on the ring
+    // thread. Errors and stops may be raised inline by start(), so no
+    // completion scheduler is advertised for them.
+    struct ring_sender_env
+    {
+        ring_scheduler query(
+            std::execution::get_completion_scheduler_t<std::execution::set_value_t>) const noexcept;
+
+        iouxx::ring* ring_ptr;
+    };
+
+    // Operation state of a ring sender. The operation itself is stored inline,
+    // so connecting and starting a sender allocates nothing.
+    // Completes with:
+    //   set_value(result) on success,
+    //   set_stopped() if cancelled (operation_canceled),
+    //   set_error(std::error_code) otherwise.
+    template<template<typename...> class Operation, typename Init, typename Receiver>
+    class ring_operation_state
+    {
+        using result_type = typename Operation<details::dummy_callback>::result_type;
+        using expected_type = std::expected<result_type, std::error_code>;
+
+        struct callback {
+            ring_operation_state* state;
+            void operator()(expected_type res) const noexcept {
+                state->complete(std::move(res));
+            }
+        };
+
+        using operation_type = Operation<callback>;
+
+        struct stop_canceller {
+            ring_operation_state* state;
+            void operator()() const noexcept {
+                state->cancel();
+            }
+        };
+
+        using stop_token_type =
+            std::stop_token_of_t<std::execution::env_of_t<Receiver>>;
+        using stop_callback_type =
+            std::stop_callback_for_t<stop_token_type, stop_canceller>;
+
+    public:
+        using operation_state_concept = std::execution::operation_state_t;
+
+        ring_operation_state(iouxx::ring& ring, Init init, Receiver rcvr)
+            noexcept(std::is_nothrow_move_constructible_v<Init>
+                && std::is_nothrow_move_constructible_v<Receiver>) :
+            init(std::move(init)), rcvr(std::move(rcvr)),
+            op(ring, std::in_place_type<callback>, this)
+        {}
+
+        ring_operation_state(const ring_operation_state&) = delete;
+        ring_operation_state& operator=(const ring_operation_state&) = delete;
+
+        void start() & noexcept {
+            std::invoke(init, op);
+            stop_token_type token = std::get_stop_token(std::execution::get_env(rcvr));
+            if (token.stop_requested()) {
+                // Never submitted
+                std::execution::set_stopped(std::move(rcvr));
+                return;
+            }
+            if (std::error_code ec = op.submit()) {
+                std::execution::set_error(std::move(rcvr), ec);
+                return;
+            }
+            if (token.stop_possible()) {
+                owner_thread = std::this_thread::get_id();
+                canceller.emplace(std::move(token), stop_canceller{ this });
+            }
+        }
+
+    private:
+        // Same as awaiter: async cancel on the ring thread, sync cancel otherwise.
+        void cancel() noexcept {
+            iouxx::ring& ring = op.owner_ring();
+            if (std::this_thread::get_id() == owner_thread) {
+                [[maybe_unused]] std::error_code ec = ring.cancel_async(op.identifier());
+            } else {
+                [[maybe_unused]] std::error_code ec = ring.cancel_sync(op.identifier());
+            }
+        }
+
+        void complete(expected_type res) noexcept {
+            // Waits for a running stop callback on another thread
+            canceller.reset();
+            if (res) {
+                if constexpr (std::is_void_v<result_type>) {
+                    std::execution::set_value(std::move(rcvr));
+                } else {
+                    std::execution::set_value(std::move(rcvr), std::move(*res));
+                }
+            } else if (res.error() == std::errc::operation_canceled) {
+                std::execution::set_stopped(std::move(rcvr));
+            } else {
+                std::execution::set_error(std::move(rcvr), res.error());
+            }
+        }
+
+        [[no_unique_address]] Init init;
+        Receiver rcvr;
+        operation_type op;
+        std::optional<stop_callback_type> canceller;
+        std::thread::id owner_thread;
+    };
+
+    struct noop_init {
+        template<typename Operation>
+        void operator()(Operation&) const noexcept {}
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Sender of a single-shot operation. Init is invoked with the operation
+    // when the operation state is started, to set up its arguments.
+    // Note: multishot operations are not supported.
+    template<template<typename...> class Operation, typename Init>
+    class ring_sender
+    {
+        using result_type = typename Operation<details::dummy_callback>::result_type;
+    public:
+        using sender_concept = std::execution::sender_t;
+        using completion_signatures = std::execution::completion_signatures<
+            typename details::sender_value_signature<result_type>::type,
+            std::execution::set_error_t(std::error_code),
+            std::execution::set_stopped_t()
+        >;
+
+        template<typename Self, typename... Env>
+        static consteval completion_signatures get_completion_signatures() noexcept {
+            return {};
+        }
+
+        ring_sender(iouxx::ring& ring, Init init)
+            noexcept(std::is_nothrow_move_constructible_v<Init>) :
+            ring_ptr(&ring), init(std::move(init))
+        {}
+
+        template<std::execution::receiver Receiver>
+        auto connect(Receiver rcvr) && {
+            return details::ring_operation_state<Operation, Init, Receiver>(
+                *ring_ptr, std::move(init), std::move(rcvr));
+        }
+
+        template<std::execution::receiver Receiver>
+            requires std::copy_constructible<Init>
+        auto connect(Receiver rcvr) const& {
+            return details::ring_operation_state<Operation, Init, Receiver>(
+                *ring_ptr, init, std::move(rcvr));
+        }
+
+        details::ring_sender_env get_env() const noexcept {
+            return { ring_ptr };
+        }
+
+    private:
+        iouxx::ring* ring_ptr;
+        [[no_unique_address]] Init init;
+    };
+
+    // Example:
+    //   auto read = make_sender<fileops::file_read_operation>(ring,
+    //       [&](auto& op) noexcept { op.file(f).buffer(buf); });
+    //   auto done = std::move(read) | std::execution::then(...);
+    template<template<typename...> class Operation, typename Init = details::noop_init>
+    ring_sender<Operation, std::decay_t<Init>> make_sender(iouxx::ring& ring, Init&& init = {})
+        noexcept(std::is_nothrow_constructible_v<std::decay_t<Init>, Init>) {
+        return ring_sender<Operation, std::decay_t<Init>>(ring, std::forward<Init>(init));
+    }
+
+    // Scheduler whose senders complete on the thread running the ring.
+    // schedule() submits a NOP, and completes when it is reaped.
+    class ring_scheduler
+    {
+    public:
+        using scheduler_concept = std::execution::scheduler_t;
+
+        explicit ring_scheduler(iouxx::ring& ring) noexcept : ring_ptr(&ring) {}
+
+        ring_sender<noop_operation, details::noop_init> schedule() const noexcept {
+            return make_sender<noop_operation>(*ring_ptr);
+        }
+
+        iouxx::ring& owner_ring() const noexcept {
+            return *ring_ptr;
+        }
+
+        friend bool operator==(const ring_scheduler&, const ring_scheduler&) = default;
+
+    private:
+        iouxx::ring* ring_ptr;
+    };
+
+} // namespace iouxx
+
+namespace iouxx::details {
+
+    inline ring_scheduler ring_sender_env::query(
+        std::execution::get_completion_scheduler_t<std::execution::set_value_t>) const noexcept {
+        return ring_scheduler(*ring_ptr);
+    }
+
+} // namespace iouxx::details
+
+#endif // __cpp_lib_senders
+
+#endif // IOUXX_EXECUTION_H
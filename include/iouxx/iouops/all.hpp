@@ -7,6 +7,9 @@
 */
 
 #include "noop.hpp" // IWYU pragma: export
+#include "link.hpp" // IWYU pragma: export
+#include "when.hpp" // IWYU pragma: export
+#include "deadline.hpp" // IWYU pragma: export
 #include "timeout.hpp" // IWYU pragma: export
 #include "cancel.hpp" // IWYU pragma: export
 #include "file/fileio.hpp" // IWYU pragma: export
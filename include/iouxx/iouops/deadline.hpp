@@ -0,0 +1,171 @@
+#pragma once
+#ifndef IOUXX_OPERATION_DEADLINE_H
+#define IOUXX_OPERATION_DEADLINE_H 1
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <chrono>
+#include <coroutine>
+#include <expected>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/macro_config.hpp" // IWYU pragma: keep
+#include "iouxx/cxxmodule_helper.hpp" // IWYU pragma: keep
+#include "iouxx/util/utility.hpp"
+#include "iouxx/util/assertion.hpp"
+#include "iouxx/iouops/timeout.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+IOUXX_EXPORT
+namespace iouxx::inline iouops {
+
+    // Operation bounded by a deadline (IORING_OP_LINK_TIMEOUT).
+    // The operation is submitted together with a linked timeout, if the
+    // deadline expires first, the kernel cancels the operation and its
+    // callback receives operation_canceled. The timeout always posts its own
+    // CQE (-ETIME if it fired, -ECANCELED if the operation completed first)
+    // with user_data 0, which the ring dispatcher reaps and drops.
+    // Note: the timespec is read by the kernel on submission, so the deadline
+    //  object must stay alive until the SQEs are submitted (e.g. next flush
+    //  of a ring in deferred submission mode).
+    template<operation Operation>
+        requires (!syncwait_operation<Operation>)
+    class operation_deadline : public details::timeout_base
+    {
+    public:
+        operation_deadline(Operation& op, std::chrono::nanoseconds timeout) noexcept : op(op) {
+            this->wait_for(timeout);
+        }
+
+        template<details::clock Clock, typename Duration>
+        operation_deadline(Operation& op,
+            std::chrono::time_point<Clock, Duration> time_point) noexcept : op(op) {
+            this->wait_until(time_point);
+        }
+
+        operation_deadline(const operation_deadline&) = delete;
+        operation_deadline& operator=(const operation_deadline&) = delete;
+
+        // Build the operation and its linked timeout into contiguous SQEs,
+        // then submit them at once.
+        std::error_code submit() & noexcept
+            requires (!awaiter_operation<Operation>) {
+            return submit_linked();
+        }
+
+        class awaiter
+        {
+            using result_type = typename Operation::result_type;
+            using expected_type = std::expected<result_type, std::error_code>;
+        public:
+            explicit awaiter(operation_deadline& deadline) noexcept : deadline(deadline) {}
+
+            awaiter(const awaiter&) = delete;
+            awaiter& operator=(const awaiter&) = delete;
+
+            constexpr bool await_ready() const noexcept { return false; }
+
+            // Expired deadline is reported as operation_canceled,
+            // rather than stopping the caller.
+            template<typename CallerPromise>
+            bool await_suspend(std::coroutine_handle<CallerPromise> handle) noexcept {
+                details::operation_access::setup_awaiter(deadline.op, handle, result, false);
+                if (std::error_code ec = deadline.submit_linked()) {
+                    result = std::unexpected(ec);
+                    return false;
+                }
+                return true;
+            }
+
+            expected_type await_resume() noexcept {
+                return std::move(result);
+            }
+
+        private:
+            operation_deadline& deadline;
+            expected_type result = std::unexpected(std::error_code());
+        };
+
+        // Example:
+        //   auto res = co_await with_deadline(recv, 100ms);
+        // Note: the awaiter is not stoppable, stop_token of the caller is
+        //  ignored, only the deadline (or the operation) ends the await.
+        awaiter operator co_await() noexcept
+            requires awaiter_operation<Operation> {
+            return awaiter(*this);
+        }
+
+    private:
+        static std::error_code link_timeout_test(iouxx::ring& ring) noexcept {
+#if defined(IOUXX_IORING_FEATURE_TESTS_ENABLED) && IOUXX_IORING_FEATURE_TESTS_ENABLED == 1
+            auto& verified = details::opcode_verified<IORING_OP_LINK_TIMEOUT>;
+            if (!verified.load(std::memory_order_relaxed)) {
+                if (!ring.opcode_supported(IORING_OP_LINK_TIMEOUT)) {
+                    return std::make_error_code(std::errc::function_not_supported);
+                }
+                verified.store(true, std::memory_order_relaxed);
+            }
+#endif // IOUXX_IORING_FEATURE_TESTS_ENABLED
+            return std::error_code();
+        }
+
+        std::error_code submit_linked() noexcept {
+            iouxx::ring& ring = op.owner_ring();
+            if (std::error_code test = op.feature_test()) {
+                return test;
+            }
+            if (std::error_code test = link_timeout_test(ring)) {
+                return test;
+            }
+            // Parked operations go first to keep submission order
+            if (ring.parked_operations() != 0
+                || ::io_uring_sq_space_left(ring.native()) < 2) {
+                if (std::error_code res = ring.flush()) {
+                    return res;
+                }
+                if (ring.parked_operations() != 0
+                    || ::io_uring_sq_space_left(ring.native()) < 2) {
+                    return std::make_error_code(std::errc::resource_unavailable_try_again);
+                }
+            }
+            ::io_uring_sqe* sqe = op.to_sqe();
+            // Space is reserved before building
+            IOUXX_ASSERT(sqe != nullptr);
+            sqe->flags |= IOSQE_IO_LINK;
+            ::io_uring_sqe* timeout_sqe = ring.get_sqe();
+            IOUXX_ASSERT(timeout_sqe != nullptr);
+            ::io_uring_prep_link_timeout(timeout_sqe, &ts, flags);
+            // CQE of the timeout itself (user_data 0) is dropped by the dispatcher
+            ::io_uring_sqe_set_data64(timeout_sqe, 0);
+            return ring.submit(timeout_sqe);
+        }
+
+        Operation& op;
+    };
+
+    // Bound operation by a relative timeout, see operation_deadline.
+    // Example:
+    //   auto deadline = with_deadline(recv, 100ms);
+    //   deadline.submit();
+    template<operation Operation, typename Rep, typename Period>
+        requires (!syncwait_operation<Operation>)
+    operation_deadline<Operation> with_deadline(Operation& op,
+        std::chrono::duration<Rep, Period> timeout) noexcept {
+        return operation_deadline<Operation>(op,
+            std::chrono::duration_cast<std::chrono::nanoseconds>(timeout));
+    }
+
+    // Bound operation by an absolute time point of steady_clock, system_clock
+    // or boottime_clock.
+    template<operation Operation, details::clock Clock, typename Duration>
+        requires (!syncwait_operation<Operation>)
+    operation_deadline<Operation> with_deadline(Operation& op,
+        std::chrono::time_point<Clock, Duration> time_point) noexcept {
+        return operation_deadline<Operation>(op, time_point);
+    }
+
+} // namespace iouxx::iouops
+
+#endif // IOUXX_OPERATION_DEADLINE_H
@@ -4,7 +4,9 @@
 
 #ifndef IOUXX_USE_CXX_MODULE
 
+#include <algorithm>
 #include <cstddef>
+#include <span>
 #include <utility>
 #include <type_traits>
 
@@ -26,6 +28,10 @@ namespace iouxx::inline iouops::fileops {
         sync    = RWF_SYNC,
         nowait  = RWF_NOWAIT,
         append  = RWF_APPEND,
+#ifdef RWF_DONTCACHE
+        // Buffered IO that drops page cache after done, since Linux 6.14
+        uncached = RWF_DONTCACHE,
+#endif // RWF_DONTCACHE
     };
 
     constexpr rw_flag operator|(rw_flag lhs, rw_flag rhs) noexcept {
@@ -181,6 +187,13 @@ namespace iouxx::details {
             return self;
         }
 
+        // Index of a buffer leased from a fixed_buffer_pool.
+        template<typename Self>
+        Self& index(this Self& self, const fixed_buffer& buf) noexcept {
+            self.buf_index = buf.index();
+            return self;
+        }
+
     protected:
         int buf_index = -1;
     };
@@ -193,6 +206,7 @@ namespace iouxx::inline iouops::fileops {
     template<utility::eligible_callback<std::ptrdiff_t> Callback>
     class file_read_operation final : public operation_base,
         public details::file_read_write_operation_base,
+        public details::rw_flag_base,
         public details::file_read_buffer_operation_base
     {
     public:
@@ -219,6 +233,7 @@ namespace iouxx::inline iouops::fileops {
         friend operation_base;
         void build(::io_uring_sqe* sqe) & noexcept {
             ::io_uring_prep_read(sqe, fd, buf, len, off);
+            sqe->rw_flags = std::to_underlying(flags);
             if (is_fixed) {
                 sqe->flags |= IOSQE_FIXED_FILE;
             }
@@ -242,9 +257,69 @@ namespace iouxx::inline iouops::fileops {
     template<typename F, typename... Args>
     file_read_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...) -> file_read_operation<F>;
 
+    // Read into a buffer selected from a buffer group (IOSQE_BUFFER_SELECT).
+    // On success, callback receives a provided_buffer lease of the bytes read,
+    // which is empty at end of file.
+    template<utility::eligible_callback<provided_buffer> Callback>
+    class file_read_provided_operation final : public operation_base,
+        public details::file_read_write_operation_base,
+        public details::rw_flag_base,
+        public details::buffer_select_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit file_read_provided_operation(iouxx::ring& ring, F&& f)
+            noexcept(utility::nothrow_constructible_callback<F>) :
+            operation_base(iouxx::op_tag<file_read_provided_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit file_read_provided_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<file_read_provided_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = provided_buffer;
+
+        static constexpr std::uint8_t opcode = IORING_OP_READ;
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            ::io_uring_prep_read(sqe, fd, nullptr, select_len, off);
+            sqe->rw_flags = std::to_underlying(flags);
+            select(sqe);
+            if (is_fixed) {
+                sqe->flags |= IOSQE_FIXED_FILE;
+            }
+        }
+
+        void do_callback(int ev, std::uint32_t cqe_flags) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if (ev >= 0) {
+                std::invoke_r<void>(callback, lease(ev, cqe_flags));
+            } else {
+                std::invoke_r<void>(callback, utility::fail(-ev));
+            }
+        }
+
+        [[no_unique_address]] callback_type callback;
+    };
+
+    template<utility::not_tag F>
+    file_read_provided_operation(iouxx::ring&, F) -> file_read_provided_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    file_read_provided_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
+        -> file_read_provided_operation<F>;
+
     template<utility::eligible_callback<std::ptrdiff_t> Callback>
     class file_read_fixed_operation final : public operation_base,
         public details::file_read_write_operation_base,
+        public details::rw_flag_base,
         public details::fixed_buffer_base,
         public details::file_read_buffer_operation_base
     {
@@ -268,10 +343,23 @@ namespace iouxx::inline iouops::fileops {
 
         static constexpr std::uint8_t opcode = IORING_OP_READ_FIXED;
 
+        using details::file_read_buffer_operation_base::buffer;
+
+        // Read into first len bytes (all by default) of a leased buffer,
+        // index included.
+        file_read_fixed_operation& buffer(const fixed_buffer& lease,
+            std::size_t len = std::dynamic_extent) & noexcept {
+            this->buf = lease.data().data();
+            this->len = std::min(len, lease.size());
+            this->buf_index = lease.index();
+            return *this;
+        }
+
     private:
         friend operation_base;
         void build(::io_uring_sqe* sqe) & noexcept {
             ::io_uring_prep_read_fixed(sqe, fd, buf, len, off, buf_index);
+            sqe->rw_flags = std::to_underlying(flags);
             if (is_fixed) {
                 sqe->flags |= IOSQE_FIXED_FILE;
             }
@@ -423,6 +511,7 @@ namespace iouxx::inline iouops::fileops {
     template<utility::eligible_callback<std::ptrdiff_t> Callback>
     class file_write_operation final : public operation_base,
         public details::file_read_write_operation_base,
+        public details::rw_flag_base,
         public details::file_write_buffer_operation_base
     {
     public:
@@ -449,6 +538,7 @@ namespace iouxx::inline iouops::fileops {
         friend operation_base;
         void build(::io_uring_sqe* sqe) & noexcept {
             ::io_uring_prep_write(sqe, fd, buf, len, off);
+            sqe->rw_flags = std::to_underlying(flags);
             if (is_fixed) {
                 sqe->flags |= IOSQE_FIXED_FILE;
             }
@@ -475,6 +565,7 @@ namespace iouxx::inline iouops::fileops {
     template<utility::eligible_callback<std::ptrdiff_t> Callback>
     class file_write_fixed_operation final : public operation_base,
         public details::file_read_write_operation_base,
+        public details::rw_flag_base,
         public details::fixed_buffer_base,
         public details::file_write_buffer_operation_base
     {
@@ -498,10 +589,23 @@ namespace iouxx::inline iouops::fileops {
 
         static constexpr std::uint8_t opcode = IORING_OP_WRITE_FIXED;
 
+        using details::file_write_buffer_operation_base::buffer;
+
+        // Write first len bytes (all by default) of a leased buffer,
+        // index included.
+        file_write_fixed_operation& buffer(const fixed_buffer& lease,
+            std::size_t len = std::dynamic_extent) & noexcept {
+            this->buf = lease.data().data();
+            this->len = std::min(len, lease.size());
+            this->buf_index = lease.index();
+            return *this;
+        }
+
     private:
         friend operation_base;
         void build(::io_uring_sqe* sqe) & noexcept {
             ::io_uring_prep_write_fixed(sqe, fd, buf, len, off, buf_index);
+            sqe->rw_flags = std::to_underlying(flags);
             if (is_fixed) {
                 sqe->flags |= IOSQE_FIXED_FILE;
             }
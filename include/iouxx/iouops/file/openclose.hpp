@@ -307,7 +307,7 @@ namespace iouxx::inline iouops::fileops {
     directory_open_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
         -> directory_open_operation<F>;
 
-    template<utility::eligible_callback<void> Callback>
+    template<utility::eligible_maybe_void_callback<void> Callback>
     class file_close_operation final : public operation_base
     {
     public:
@@ -372,11 +372,61 @@ namespace iouxx::inline iouops::fileops {
         [[no_unique_address]] callback_type callback;
     };
 
+    // Pure close operation, does nothing on completion.
+    template<>
+    class file_close_operation<void> final : public operation_base
+    {
+    public:
+        explicit file_close_operation(iouxx::ring& ring) noexcept :
+            operation_base(iouxx::op_tag<file_close_operation>, ring)
+        {}
+
+        explicit file_close_operation(iouxx::ring& ring, std::in_place_type_t<void>) noexcept :
+            operation_base(iouxx::op_tag<file_close_operation>, ring)
+        {}
+
+        using callback_type = void;
+        using result_type = void;
+
+        static constexpr std::uint8_t opcode = IORING_OP_CLOSE;
+
+        file_close_operation& file(const file& f) & noexcept {
+            this->fd = f.native_handle();
+            this->is_fixed = false;
+            return *this;
+        }
+
+        file_close_operation& file(const fixed_file& f) & noexcept {
+            this->fd = f.index();
+            this->is_fixed = true;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            if (is_fixed) {
+                ::io_uring_prep_close_direct(sqe, fd);
+            } else {
+                ::io_uring_prep_close(sqe, fd);
+            }
+        }
+
+        void do_callback(int, std::int32_t) noexcept {}
+
+        int fd = -1;
+        bool is_fixed = false;
+    };
+
     template<utility::not_tag F>
     file_close_operation(iouxx::ring&, F) -> file_close_operation<std::decay_t<F>>;
 
     template<typename F, typename... Args>
     file_close_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...) -> file_close_operation<F>;
+
+    file_close_operation(iouxx::ring&) -> file_close_operation<void>;
+
+    file_close_operation(iouxx::ring&, std::in_place_type_t<void>) -> file_close_operation<void>;
     
     template<utility::eligible_callback<fixed_file> Callback>
     class fixed_file_register_operation final : public operation_base
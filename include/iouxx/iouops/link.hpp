@@ -0,0 +1,118 @@
+#pragma once
+#ifndef IOUXX_OPERATION_LINK_H
+#define IOUXX_OPERATION_LINK_H 1
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <cstddef>
+#include <tuple>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/macro_config.hpp" // IWYU pragma: keep
+#include "iouxx/cxxmodule_helper.hpp" // IWYU pragma: keep
+#include "iouxx/util/utility.hpp"
+#include "iouxx/util/assertion.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+IOUXX_EXPORT
+namespace iouxx::inline iouops {
+
+    // A chain of operations linked by IOSQE_IO_LINK.
+    // Steps are executed in order, each step starts only after previous one
+    // completes. If a step fails (or short read/write), following steps are
+    // completed with operation_canceled. With hardlink enabled, following
+    // steps are executed regardless of result of previous one.
+    // Every step reports its own result through its own callback,
+    // all SQEs of the chain are submitted at once.
+    // Note: operations are referenced, not copied, they must outlive the chain
+    //  and stay unchanged until their completion.
+    template<operation... Operations>
+        requires (sizeof...(Operations) >= 1)
+            && ((!syncwait_operation<Operations> && !awaiter_operation<Operations>) && ...)
+    class operation_chain
+    {
+    public:
+        explicit operation_chain(Operations&... ops) noexcept : ops(ops...) {}
+
+        static constexpr std::size_t size() noexcept {
+            return sizeof...(Operations);
+        }
+
+        // Use IOSQE_IO_HARDLINK instead of IOSQE_IO_LINK.
+        operation_chain& hardlink(bool enable = true) & noexcept {
+            hard = enable;
+            return *this;
+        }
+
+        // Build all steps into contiguous SQEs, then submit them at once.
+        // If there is not enough space in submission queue, or there are
+        // parked operations, pending SQEs are flushed first.
+        // Nothing is built if any step fails feature test.
+        std::error_code submit() & noexcept {
+            iouxx::ring& ring = std::get<0>(ops).owner_ring();
+            if (std::error_code test = std::apply(
+                [&ring](auto&... op) noexcept {
+                    std::error_code res;
+                    ((res = res ? res : check(ring, op)), ...);
+                    return res;
+                }, ops)) {
+                return test;
+            }
+            // Parked operations go first to keep submission order
+            if (ring.parked_operations() != 0
+                || ::io_uring_sq_space_left(ring.native()) < size()) {
+                if (std::error_code res = ring.flush()) {
+                    return res;
+                }
+                if (ring.parked_operations() != 0
+                    || ::io_uring_sq_space_left(ring.native()) < size()) {
+                    return std::make_error_code(std::errc::resource_unavailable_try_again);
+                }
+            }
+            const unsigned link_flag = hard ? IOSQE_IO_HARDLINK : IOSQE_IO_LINK;
+            ::io_uring_sqe* last = std::apply(
+                [link_flag](auto&... op) noexcept {
+                    ::io_uring_sqe* sqe = nullptr;
+                    ((sqe = build_step(op, link_flag)), ...);
+                    return sqe;
+                }, ops);
+            // The last SQE terminates the chain
+            last->flags &= ~link_flag;
+            return ring.submit(last);
+        }
+
+    private:
+        template<typename Operation>
+        static std::error_code check(iouxx::ring& ring, Operation& op) noexcept {
+            // All steps must be on the same ring
+            IOUXX_ASSERT(&op.owner_ring() == &ring);
+            return op.feature_test();
+        }
+
+        template<typename Operation>
+        static ::io_uring_sqe* build_step(Operation& op, unsigned link_flag) noexcept {
+            ::io_uring_sqe* sqe = op.to_sqe();
+            // Space is reserved before building
+            IOUXX_ASSERT(sqe != nullptr);
+            sqe->flags |= link_flag;
+            return sqe;
+        }
+
+        std::tuple<Operations&...> ops;
+        bool hard = false;
+    };
+
+    template<operation... Operations>
+    operation_chain(Operations&...) -> operation_chain<Operations...>;
+
+    // Link operations into a chain, see operation_chain.
+    template<operation... Operations>
+    operation_chain<Operations...> link(Operations&... ops) noexcept {
+        return operation_chain<Operations...>(ops...);
+    }
+
+} // namespace iouxx::iouops
+
+#endif // IOUXX_OPERATION_LINK_H
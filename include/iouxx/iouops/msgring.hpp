@@ -0,0 +1,271 @@
+#pragma once
+#ifndef IOUXX_OPERATION_MSGRING_H
+#define IOUXX_OPERATION_MSGRING_H 1
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <type_traits>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/util/utility.hpp"
+#include "iouxx/macro_config.hpp" // IWYU pragma: keep
+#include "iouxx/cxxmodule_helper.hpp" // IWYU pragma: keep
+#include "iouxx/iouops/file/file.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+namespace iouxx::details {
+
+    class msg_ring_base
+    {
+    public:
+        // Ring to post the message to.
+        // Note: always addressed by its real fd, registered ring fd of
+        //  target ring belongs to another thread.
+        template<typename Self>
+        Self& target(this Self& self, const iouxx::ring& ring) noexcept {
+            self.ring_fd = details::get_native_handle(ring);
+            return self;
+        }
+
+        // Operation on target ring whose callback receives the message,
+        // e.g. a ring_management_operation. It is never submitted by itself,
+        // and it may receive any number of messages.
+        template<typename Self>
+        Self& receiver(this Self& self, operation_identifier identifier) noexcept {
+            self.id = identifier;
+            return self;
+        }
+
+    protected:
+        int ring_fd = -1;
+        operation_identifier id = operation_identifier();
+    };
+
+    class msg_ring_data_base
+    {
+    public:
+        // Passed to receiver as result (ev).
+        template<typename Self>
+        Self& message(this Self& self, std::int32_t value) noexcept {
+            self.value = value;
+            return self;
+        }
+
+        // Passed to receiver as cqe flags.
+        template<typename Self>
+        Self& message_flags(this Self& self, std::uint32_t flags) noexcept {
+            self.cqe_flags = flags;
+            self.pass_flags = true;
+            return self;
+        }
+
+    protected:
+        void prep(::io_uring_sqe* sqe, int ring_fd, operation_identifier id) const noexcept {
+            if (pass_flags) {
+                ::io_uring_prep_msg_ring_cqe_flags(sqe, ring_fd,
+                    static_cast<unsigned int>(value), id.user_data64(), 0, cqe_flags);
+            } else {
+                ::io_uring_prep_msg_ring(sqe, ring_fd,
+                    static_cast<unsigned int>(value), id.user_data64(), 0);
+            }
+        }
+
+        std::int32_t value = 0;
+        std::uint32_t cqe_flags = 0;
+        bool pass_flags = false;
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx::inline iouops {
+
+    // Post a CQE to another ring (IORING_OP_MSG_RING), which invokes
+    // callback of receiver operation on that ring with given message.
+    // No syscall or lock is needed on the target side.
+    template<utility::eligible_maybe_void_callback<void> Callback>
+    class msg_ring_operation final : public operation_base,
+        public details::msg_ring_base,
+        public details::msg_ring_data_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit msg_ring_operation(iouxx::ring& ring, F&& f)
+            noexcept(utility::nothrow_constructible_callback<F>) :
+            operation_base(iouxx::op_tag<msg_ring_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit msg_ring_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<msg_ring_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = void;
+
+        static constexpr std::uint8_t opcode = IORING_OP_MSG_RING;
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            prep(sqe, ring_fd, id);
+        }
+
+        void do_callback(int ev, std::uint32_t) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if constexpr (utility::stdexpected_callback<callback_type, void>) {
+                if (ev == 0) {
+                    std::invoke_r<void>(callback, utility::void_success());
+                } else {
+                    std::invoke_r<void>(callback, utility::fail(-ev));
+                }
+            } else if constexpr (utility::errorcode_callback<callback_type>) {
+                std::invoke_r<void>(callback, utility::make_system_error_code(-ev));
+            } else {
+                static_assert(false, "Unreachable");
+            }
+        }
+
+        [[no_unique_address]] callback_type callback;
+    };
+
+    // Pure message operation, does nothing on completion.
+    // Mainly used for waking up thread of another ring.
+    template<>
+    class msg_ring_operation<void> final : public operation_base,
+        public details::msg_ring_base,
+        public details::msg_ring_data_base
+    {
+    public:
+        explicit msg_ring_operation(iouxx::ring& ring) noexcept :
+            operation_base(iouxx::op_tag<msg_ring_operation>, ring)
+        {}
+
+        explicit msg_ring_operation(iouxx::ring& ring, std::in_place_type_t<void>) noexcept :
+            operation_base(iouxx::op_tag<msg_ring_operation>, ring)
+        {}
+
+        using callback_type = void;
+        using result_type = void;
+
+        static constexpr std::uint8_t opcode = IORING_OP_MSG_RING;
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            prep(sqe, ring_fd, id);
+        }
+
+        void do_callback(int, std::int32_t) noexcept {}
+    };
+
+    template<utility::not_tag F>
+    msg_ring_operation(iouxx::ring&, F) -> msg_ring_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    msg_ring_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...) -> msg_ring_operation<F>;
+
+    msg_ring_operation(iouxx::ring&) -> msg_ring_operation<void>;
+
+    msg_ring_operation(iouxx::ring&, std::in_place_type_t<void>) -> msg_ring_operation<void>;
+
+    // Move a fixed file of this ring into direct descriptor table of another
+    // ring (IORING_OP_MSG_RING with IORING_MSG_SEND_FD).
+    // On success, callback receives the fixed file slot in target ring.
+    // Unless skipped, receiver on target ring gets a CQE with the allocated
+    // slot as result (0 if destination() is given).
+    // Note: source slot stays installed, close it if it is no longer needed.
+    template<utility::eligible_callback<fileops::fixed_file> Callback>
+    class msg_ring_fd_operation final : public operation_base,
+        public details::msg_ring_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit msg_ring_fd_operation(iouxx::ring& ring, F&& f)
+            noexcept(utility::nothrow_constructible_callback<F>) :
+            operation_base(iouxx::op_tag<msg_ring_fd_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit msg_ring_fd_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<msg_ring_fd_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = fileops::fixed_file;
+
+        static constexpr std::uint8_t opcode = IORING_OP_MSG_RING;
+
+        msg_ring_fd_operation& source(fileops::fixed_file file) & noexcept {
+            source_index = file.index();
+            return *this;
+        }
+
+        // Install into given slot of target ring.
+        // By default, a free slot is allocated.
+        msg_ring_fd_operation& destination(fileops::fixed_file file) & noexcept {
+            target_index = file.index();
+            return *this;
+        }
+
+        msg_ring_fd_operation& destination_alloc() & noexcept {
+            target_index = -1;
+            return *this;
+        }
+
+        // Do not post CQE to target ring (IORING_MSG_RING_CQE_SKIP).
+        msg_ring_fd_operation& skip_target_cqe(bool enable = true) & noexcept {
+            skip_target = enable;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            const unsigned int flags = skip_target ? IORING_MSG_RING_CQE_SKIP : 0;
+            if (target_index < 0) {
+                ::io_uring_prep_msg_ring_fd_alloc(sqe, ring_fd, source_index,
+                    id.user_data64(), flags);
+            } else {
+                ::io_uring_prep_msg_ring_fd(sqe, ring_fd, source_index, target_index,
+                    id.user_data64(), flags);
+            }
+        }
+
+        void do_callback(int ev, std::uint32_t) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if (ev >= 0) {
+                // Kernel reports allocated slot only, explicit slot yields 0
+                std::invoke_r<void>(callback,
+                    fileops::fixed_file(target_index >= 0 ? target_index : ev));
+            } else {
+                std::invoke_r<void>(callback, utility::fail(-ev));
+            }
+        }
+
+        int source_index = -1;
+        int target_index = -1;
+        bool skip_target = false;
+        [[no_unique_address]] callback_type callback;
+    };
+
+    template<utility::not_tag F>
+    msg_ring_fd_operation(iouxx::ring&, F) -> msg_ring_fd_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    msg_ring_fd_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
+        -> msg_ring_fd_operation<F>;
+
+} // namespace iouxx::iouops
+
+#endif // IOUXX_OPERATION_MSGRING_H
@@ -4,7 +4,9 @@
 
 #ifndef IOUXX_USE_CXX_MODULE
 
+#include <algorithm>
 #include <cstddef>
+#include <span>
 #include <utility>
 #include <functional>
 #include <utility>
@@ -164,6 +166,17 @@ namespace iouxx::details {
             return self;
         }
 
+        // Send first len bytes (all by default) of a buffer leased from
+        // a fixed_buffer_pool, as a registered buffer.
+        template<typename Self>
+        Self& buffer(this Self& self, const fixed_buffer& lease,
+            std::size_t len = std::dynamic_extent) noexcept {
+            self.buf = lease.data().data();
+            self.len = std::min(len, lease.size());
+            self.buf_index = lease.index();
+            return self;
+        }
+
         template<typename Self>
         Self& options(this Self& self, send_flag flags) noexcept {
             self.flags = flags;
@@ -586,28 +599,242 @@ namespace iouxx::inline iouops::network {
     socket_recv_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
         -> socket_recv_operation<F>;
 
-    template<utility::byte_unit ByteType>
+    // Receive into a buffer selected from a buffer group (IOSQE_BUFFER_SELECT).
+    // On success, callback receives a provided_buffer lease of received bytes,
+    // which is empty if peer closed.
+    template<utility::eligible_callback<provided_buffer> Callback>
+    class socket_recv_provided_operation final : public operation_base,
+        public details::send_recv_socket_base,
+        public details::buffer_select_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit socket_recv_provided_operation(iouxx::ring& ring, F&& f)
+            noexcept(utility::nothrow_constructible_callback<F>) :
+            operation_base(iouxx::op_tag<socket_recv_provided_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit socket_recv_provided_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<socket_recv_provided_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = provided_buffer;
+        using recv_flag = iouops::network::recv_flag;
+
+        static constexpr std::uint8_t opcode = IORING_OP_RECV;
+
+        socket_recv_provided_operation& options(recv_flag flags) & noexcept {
+            this->flags = flags;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            ::io_uring_prep_recv(sqe, fd, nullptr, select_len,
+                std::to_underlying(flags));
+            select(sqe);
+            if (is_fixed) {
+                sqe->flags |= IOSQE_FIXED_FILE;
+            }
+        }
+
+        void do_callback(int ev, std::uint32_t cqe_flags) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if (ev >= 0) {
+                std::invoke_r<void>(callback, lease(ev, cqe_flags));
+            } else {
+                std::invoke_r<void>(callback, utility::fail(-ev));
+            }
+        }
+
+        recv_flag flags = recv_flag::none;
+        [[no_unique_address]] callback_type callback;
+    };
+
+    template<utility::not_tag F>
+    socket_recv_provided_operation(iouxx::ring&, F) -> socket_recv_provided_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    socket_recv_provided_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
+        -> socket_recv_provided_operation<F>;
+
+    // Receive into consecutive buffers of a buffer group at once
+    // (IORING_RECVSEND_BUNDLE), filling as many buffers as data is available.
+    // On success, callback receives a provided_buffer_bundle of leases in
+    // order of received data, which is empty if peer closed.
+    // Note: requires ring::feature::recvsend_bundle (Linux 6.10),
+    //  and a group not consumed incrementally.
+    template<utility::eligible_callback<provided_buffer_bundle> Callback>
+    class socket_recv_bundle_operation final : public operation_base,
+        public details::send_recv_socket_base,
+        public details::buffer_select_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit socket_recv_bundle_operation(iouxx::ring& ring, F&& f)
+            noexcept(utility::nothrow_constructible_callback<F>) :
+            operation_base(iouxx::op_tag<socket_recv_bundle_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit socket_recv_bundle_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<socket_recv_bundle_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = provided_buffer_bundle;
+        using recv_flag = iouops::network::recv_flag;
+
+        static constexpr std::uint8_t opcode = IORING_OP_RECV;
+
+        socket_recv_bundle_operation& options(recv_flag flags) & noexcept {
+            this->flags = flags;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            ::io_uring_prep_recv(sqe, fd, nullptr, select_len,
+                std::to_underlying(flags));
+            sqe->ioprio |= IORING_RECVSEND_BUNDLE;
+            select(sqe);
+            if (is_fixed) {
+                sqe->flags |= IOSQE_FIXED_FILE;
+            }
+        }
+
+        void do_callback(int ev, std::uint32_t cqe_flags) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if (ev >= 0) {
+                std::invoke_r<void>(callback, lease_bundle(ev, cqe_flags));
+            } else {
+                std::invoke_r<void>(callback, utility::fail(-ev));
+            }
+        }
+
+        recv_flag flags = recv_flag::none;
+        [[no_unique_address]] callback_type callback;
+    };
+
+    template<utility::not_tag F>
+    socket_recv_bundle_operation(iouxx::ring&, F) -> socket_recv_bundle_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    socket_recv_bundle_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
+        -> socket_recv_bundle_operation<F>;
+
+    struct send_bundle_result {
+        std::size_t bytes_sent;
+        // Buffers sent, starting from first_bid in queued order
+        std::uint16_t first_bid;
+        std::uint32_t buffers;
+    };
+
+    // Send buffers queued in a buffer group (IORING_RECVSEND_BUNDLE),
+    // as many as the socket accepts in one go, in the order they are inserted.
+    // Sent buffers leave the group, and can be inserted again to queue more
+    // data once the completion arrives.
+    // Note: requires ring::feature::recvsend_bundle (Linux 6.10).
+    //  Queue buffers by ring::buffer_group::insert() only, on a group
+    //  dedicated to sending.
+    template<utility::eligible_callback<send_bundle_result> Callback>
+    class socket_send_bundle_operation final : public operation_base,
+        public details::send_recv_socket_base,
+        public details::buffer_select_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit socket_send_bundle_operation(iouxx::ring& ring, F&& f)
+            noexcept(utility::nothrow_constructible_callback<F>) :
+            operation_base(iouxx::op_tag<socket_send_bundle_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit socket_send_bundle_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<socket_send_bundle_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = send_bundle_result;
+        using send_flag = iouops::network::send_flag;
+
+        static constexpr std::uint8_t opcode = IORING_OP_SEND;
+
+        socket_send_bundle_operation& options(send_flag flags) & noexcept {
+            this->flags = flags;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            ::io_uring_prep_send(sqe, fd, nullptr, select_len,
+                std::to_underlying(flags));
+            sqe->ioprio |= IORING_RECVSEND_BUNDLE;
+            select(sqe);
+            if (is_fixed) {
+                sqe->flags |= IOSQE_FIXED_FILE;
+            }
+        }
+
+        void do_callback(int ev, std::uint32_t cqe_flags) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if (ev >= 0) {
+                std::invoke_r<void>(callback, result_type{
+                    .bytes_sent = static_cast<std::size_t>(ev),
+                    .first_bid = static_cast<std::uint16_t>(cqe_flags >> IORING_CQE_BUFFER_SHIFT),
+                    .buffers = dequeue(ev, cqe_flags)
+                });
+            } else {
+                std::invoke_r<void>(callback, utility::fail(-ev));
+            }
+        }
+
+        send_flag flags = send_flag::none;
+        [[no_unique_address]] callback_type callback;
+    };
+
+    template<utility::not_tag F>
+    socket_send_bundle_operation(iouxx::ring&, F) -> socket_send_bundle_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    socket_send_bundle_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
+        -> socket_send_bundle_operation<F>;
+
     struct multishot_recv_result {
-        using value_type = std::span<ByteType>::value_type;
-        std::span<ByteType> data;
+        // Empty if nothing is received (peer closed).
+        provided_buffer buffer;
         bool more;
     };
 
-    template<typename Callback>
-        requires utility::eligible_alternative_callback<Callback,
-            multishot_recv_result<std::byte>,
-            multishot_recv_result<unsigned char>>
+    // Receive repeatedly into buffers selected from a buffer group,
+    // one CQE (and one provided_buffer) per receive, no resubmission needed.
+    // Stops with no_buffer_space (ENOBUFS) if the group runs out of buffers,
+    // keep leases short or the group large enough.
+    // Note: leave limit() at 0 before Linux 6.10, where a nonzero length
+    //  fails the multishot receive with invalid_argument (EINVAL).
+    template<utility::eligible_callback<multishot_recv_result> Callback>
     class socket_multishot_recv_operation final : public operation_base,
         public details::send_recv_socket_base,
-        public details::recv_op_base
+        public details::buffer_select_base
     {
         static_assert(!utility::is_specialization_of_v<syncwait_callback, Callback>,
             "Multishot operation does not support syncronous wait.");
         static_assert(!utility::is_specialization_of_v<awaiter_callback, Callback>,
             "Multishot operation does not support coroutine await.");
-        using chosen_traits = utility::chosen_result<
-            Callback, multishot_recv_result<std::byte>, multishot_recv_result<unsigned char>
-        >;
     public:
         template<utility::not_tag F>
         explicit socket_multishot_recv_operation(iouxx::ring& ring, F&& f)
@@ -624,34 +851,33 @@ namespace iouxx::inline iouops::network {
         {}
 
         using callback_type = Callback;
-        using result_type = chosen_traits::type;
+        using result_type = multishot_recv_result;
+        using recv_flag = iouops::network::recv_flag;
 
         static constexpr std::uint8_t opcode = IORING_OP_RECV;
 
+        socket_multishot_recv_operation& options(recv_flag flags) & noexcept {
+            this->flags = flags;
+            return *this;
+        }
+
     private:
         friend operation_base;
         void build(::io_uring_sqe* sqe) & noexcept {
-            ::io_uring_prep_recv_multishot(sqe, fd, buf, len,
+            ::io_uring_prep_recv_multishot(sqe, fd, nullptr, select_len,
                 std::to_underlying(flags));
+            select(sqe);
             if (is_fixed) {
                 sqe->flags |= IOSQE_FIXED_FILE;
             }
-            if (buf_index >= 0) {
-                sqe->buf_index = buf_index;
-                sqe->ioprio |= IORING_RECVSEND_FIXED_BUF;
-            }
         }
 
-        void do_callback(int ev, std::uint32_t cqe_flags)
-            IOUXX_CALLBACK_NOEXCEPT_IF(chosen_traits::nothrow) {
-            using byte_type = result_type::value_type;
+        void do_callback(int ev, std::uint32_t cqe_flags) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
             if (ev >= 0) {
                 const bool more = cqe_flags & IORING_CQE_F_MORE;
                 std::invoke_r<void>(callback, result_type{
-                    .data = std::span<byte_type>(
-                        static_cast<byte_type*>(buf),
-                        static_cast<std::size_t>(ev)
-                    ),
+                    .buffer = lease(ev, cqe_flags),
                     .more = more
                 });
             } else {
@@ -659,6 +885,7 @@ namespace iouxx::inline iouops::network {
             }
         }
 
+        recv_flag flags = recv_flag::none;
         [[no_unique_address]] callback_type callback;
     };
 
@@ -354,6 +354,134 @@ namespace iouxx::inline iouops {
     timeout_cancel_operation(iouxx::ring&, std::in_place_type_t<void>)
         -> timeout_cancel_operation<void>;
 
+    // Modify expiration of a previously submitted timeout in place
+    // (IORING_TIMEOUT_UPDATE), instead of cancelling and resubmitting it.
+    // With linked(), the target is a linked timeout (IORING_OP_LINK_TIMEOUT).
+    // Note: the target keeps its own clock, clock of wait_for/wait_until is
+    //  ignored, only relative/absolute mode is passed.
+    // Fails with no_such_file_or_directory (ENOENT) if target is not found,
+    // or connection_already_in_progress (EALREADY) if it is already firing.
+    template<utility::eligible_maybe_void_callback<void> Callback>
+    class timeout_update_operation final : public operation_base,
+        public details::timeout_base
+    {
+    public:
+        template<utility::not_tag F>
+        timeout_update_operation(iouxx::ring& ring, F&& f) noexcept :
+            operation_base(iouxx::op_tag<timeout_update_operation>, ring),
+            callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        timeout_update_operation(iouxx::ring& ring, std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            operation_base(iouxx::op_tag<timeout_update_operation>, ring),
+            callback(std::forward<Args>(args)...)
+        {}
+
+        using callback_type = Callback;
+        using result_type = void;
+
+        static constexpr std::uint8_t opcode = IORING_OP_TIMEOUT_REMOVE;
+
+        timeout_update_operation& target(operation_identifier identifier) & noexcept {
+            id = identifier;
+            return *this;
+        }
+
+        timeout_update_operation& linked(bool enable = true) & noexcept {
+            link_timeout = enable;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            // Kernel rejects clock flags on update
+            unsigned update_flags = flags & IORING_TIMEOUT_ABS;
+            if (link_timeout) {
+                update_flags |= IORING_LINK_TIMEOUT_UPDATE;
+            }
+            ::io_uring_prep_timeout_update(sqe, &ts, id.user_data64(), update_flags);
+        }
+
+        void do_callback(int ev, std::uint32_t) IOUXX_CALLBACK_NOEXCEPT_IF(
+            utility::eligible_nothrow_callback<callback_type, result_type>) {
+            if constexpr (utility::stdexpected_callback<callback_type, void>) {
+                if (ev == 0) {
+                    std::invoke_r<void>(callback, utility::void_success());
+                } else {
+                    std::invoke_r<void>(callback, utility::fail(-ev));
+                }
+            } else if constexpr (utility::errorcode_callback<callback_type>) {
+                std::invoke_r<void>(callback, utility::make_system_error_code(-ev));
+            } else {
+                static_assert(false, "Unreachable");
+            }
+        }
+
+        operation_identifier id = operation_identifier();
+        bool link_timeout = false;
+        [[no_unique_address]] callback_type callback;
+    };
+
+    // Pure timeout update operation, does nothing on completion.
+    template<>
+    class timeout_update_operation<void> final : public operation_base,
+        public details::timeout_base
+    {
+    public:
+        explicit timeout_update_operation(iouxx::ring& ring) noexcept :
+            operation_base(iouxx::op_tag<timeout_update_operation>, ring)
+        {}
+
+        explicit timeout_update_operation(iouxx::ring& ring, std::in_place_type_t<void>) noexcept :
+            operation_base(iouxx::op_tag<timeout_update_operation>, ring)
+        {}
+
+        using callback_type = void;
+        using result_type = void;
+
+        static constexpr std::uint8_t opcode = IORING_OP_TIMEOUT_REMOVE;
+
+        timeout_update_operation& target(operation_identifier identifier) & noexcept {
+            id = identifier;
+            return *this;
+        }
+
+        timeout_update_operation& linked(bool enable = true) & noexcept {
+            link_timeout = enable;
+            return *this;
+        }
+
+    private:
+        friend operation_base;
+        void build(::io_uring_sqe* sqe) & noexcept {
+            unsigned update_flags = flags & IORING_TIMEOUT_ABS;
+            if (link_timeout) {
+                update_flags |= IORING_LINK_TIMEOUT_UPDATE;
+            }
+            ::io_uring_prep_timeout_update(sqe, &ts, id.user_data64(), update_flags);
+        }
+
+        void do_callback(int, std::int32_t) noexcept {}
+
+        operation_identifier id = operation_identifier();
+        bool link_timeout = false;
+    };
+
+    template<utility::not_tag F>
+    timeout_update_operation(iouxx::ring&, F) -> timeout_update_operation<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    timeout_update_operation(iouxx::ring&, std::in_place_type_t<F>, Args&&...)
+        -> timeout_update_operation<F>;
+
+    timeout_update_operation(iouxx::ring&) -> timeout_update_operation<void>;
+
+    timeout_update_operation(iouxx::ring&, std::in_place_type_t<void>)
+        -> timeout_update_operation<void>;
+
 } // namespace iouxx::iouops
 
 #endif // IOUXX_OPERATION_TIMEOUT_H
@@ -0,0 +1,188 @@
+#pragma once
+#ifndef IOUXX_OPERATION_WHEN_H
+#define IOUXX_OPERATION_WHEN_H 1
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <cstddef>
+#include <coroutine>
+#include <expected>
+#include <tuple>
+#include <utility>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/macro_config.hpp" // IWYU pragma: keep
+#include "iouxx/cxxmodule_helper.hpp" // IWYU pragma: keep
+#include "iouxx/util/utility.hpp"
+#include "iouxx/util/assertion.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+IOUXX_EXPORT
+namespace iouxx::inline iouops {
+
+    // Result of when_any: index of the first completed operation,
+    // and results of all operations.
+    // If the batch could not be submitted, index is none and all results
+    // hold the submission error.
+    template<typename... Results>
+    struct when_any_result
+    {
+        static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+        std::size_t index = none;
+        std::tuple<Results...> results;
+    };
+
+} // namespace iouxx::iouops
+
+namespace iouxx::details {
+
+    template<typename Operation>
+    using awaiter_expected_t =
+        std::expected<typename Operation::result_type, std::error_code>;
+
+    // Awaits a group of awaiter operations submitted in one batch.
+    // With Any, the first completion cancels the others. In both cases the
+    // coroutine is resumed once, after every operation has completed,
+    // since the operations live in the awaiting coroutine.
+    template<bool Any, awaiter_operation... Operations>
+    class join_awaiter : private join_state
+    {
+    public:
+        explicit join_awaiter(Operations&... ops) noexcept :
+            ops(ops...),
+            results(awaiter_expected_t<Operations>(std::unexpect)...)
+        {
+            if constexpr (Any) {
+                this->on_first = &cancel_others;
+            }
+        }
+
+        join_awaiter(const join_awaiter&) = delete;
+        join_awaiter& operator=(const join_awaiter&) = delete;
+
+        constexpr bool await_ready() const noexcept { return false; }
+
+        // Note: if the ring is in deferred submission mode, the operations
+        //  are only prepared here, and submitted on next flush of the ring.
+        template<typename CallerPromise>
+        bool await_suspend(std::coroutine_handle<CallerPromise> handle) noexcept {
+            this->handle = handle;
+            this->remaining = sizeof...(Operations);
+            this->first = none;
+            if (std::error_code ec = submit_all(std::index_sequence_for<Operations...>())) {
+                // Nothing is submitted, resume immediately
+                std::apply([&ec](auto&... res) noexcept {
+                    ((res = std::unexpected(ec)), ...);
+                }, results);
+                return false;
+            }
+            return true;
+        }
+
+        auto await_resume() noexcept {
+            if constexpr (Any) {
+                return when_any_result<awaiter_expected_t<Operations>...>{
+                    this->first, std::move(results)
+                };
+            } else {
+                return std::move(results);
+            }
+        }
+
+    private:
+        template<typename Operation>
+        static std::error_code check(iouxx::ring& ring, Operation& op) noexcept {
+            // All operations must be on the same ring
+            IOUXX_ASSERT(&op.owner_ring() == &ring);
+            return op.feature_test();
+        }
+
+        template<typename Operation, typename Result>
+        ::io_uring_sqe* build(Operation& op, std::size_t index, Result& result) noexcept {
+            operation_access::setup_join(op, *this, index, result);
+            ::io_uring_sqe* sqe = op.to_sqe();
+            // Space is reserved before building
+            IOUXX_ASSERT(sqe != nullptr);
+            return sqe;
+        }
+
+        // Build all operations into contiguous SQEs and submit them at once.
+        // Nothing is built if any of them fails feature test.
+        template<std::size_t... I>
+        std::error_code submit_all(std::index_sequence<I...>) noexcept {
+            iouxx::ring& ring = std::get<0>(ops).owner_ring();
+            std::error_code res;
+            ((res = res ? res : check(ring, std::get<I>(ops))), ...);
+            if (res) {
+                return res;
+            }
+            constexpr std::size_t count = sizeof...(Operations);
+            if (ring.parked_operations() != 0
+                || ::io_uring_sq_space_left(ring.native()) < count) {
+                if (std::error_code ec = ring.flush()) {
+                    return ec;
+                }
+                if (ring.parked_operations() != 0
+                    || ::io_uring_sq_space_left(ring.native()) < count) {
+                    return std::make_error_code(std::errc::resource_unavailable_try_again);
+                }
+            }
+            ::io_uring_sqe* last = nullptr;
+            ((last = build(std::get<I>(ops), I, std::get<I>(results))), ...);
+            // Once built, SQEs stay in SQ even if this submission fails,
+            // they are submitted by the next flush and complete as usual.
+            [[maybe_unused]] std::error_code ec = ring.submit(last);
+            return std::error_code();
+        }
+
+        // Best effort: if the cancel request cannot be queued,
+        // the others just complete normally.
+        static void cancel_others(join_state& join, std::size_t first) noexcept {
+            auto& self = static_cast<join_awaiter&>(join);
+            std::size_t index = 0;
+            std::apply([first, &index](auto&... op) noexcept {
+                ((index++ != first
+                    ? static_cast<void>(op.owner_ring().cancel_async(op.identifier()))
+                    : static_cast<void>(0)), ...);
+            }, self.ops);
+        }
+
+        std::tuple<Operations&...> ops;
+        std::tuple<awaiter_expected_t<Operations>...> results;
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx::inline iouops {
+
+    // Await all operations, submitted in one batch.
+    // Yields a tuple of std::expected results, in order of operations.
+    // Example:
+    //   auto read = ring.make_await<file_read_operation>();
+    //   auto timer = ring.make_await<timeout_operation>();
+    //   ...
+    //   auto [r, t] = co_await when_all(read, timer);
+    // Note: operations are referenced, they must not be in flight already.
+    template<awaiter_operation... Operations>
+        requires (sizeof...(Operations) >= 1)
+    details::join_awaiter<false, Operations...> when_all(Operations&... ops) noexcept {
+        return details::join_awaiter<false, Operations...>(ops...);
+    }
+
+    // Await the first completed one of operations, submitted in one batch.
+    // The others are cancelled by IORING_OP_ASYNC_CANCEL, and the coroutine
+    // is resumed after all of them complete (usually with operation_canceled).
+    // Yields a when_any_result.
+    template<awaiter_operation... Operations>
+        requires (sizeof...(Operations) >= 1)
+    details::join_awaiter<true, Operations...> when_any(Operations&... ops) noexcept {
+        return details::join_awaiter<true, Operations...>(ops...);
+    }
+
+} // namespace iouxx::iouops
+
+#endif // IOUXX_OPERATION_WHEN_H
@@ -19,6 +19,10 @@
 #include <expected>
 #include <span>
 #include <ranges>
+#include <array>
+#include <bitset>
+#include <atomic>
+#include <algorithm>
 #include <vector>
 #include <chrono>
 #include <memory>
@@ -27,6 +31,9 @@
 #include <limits>
 #include <format>
 #include <functional>
+#include <optional>
+#include <stop_token>
+#include <thread>
 
 #include "macro_config.hpp"
 #include "cxxmodule_helper.hpp"
@@ -44,6 +51,15 @@ namespace iouxx {
     // Forward declaration
     class operation_result;
 
+    // Forward declaration
+    class provided_buffer;
+
+    // Forward declaration
+    class provided_buffer_bundle;
+
+    // Forward declaration
+    class fixed_buffer_pool;
+
     inline namespace iouops {
 
         // Forward declaration
@@ -55,6 +71,9 @@ namespace iouxx {
 
 namespace iouxx::details {
 
+    // Forward declaration
+    class buffer_select_base;
+
     // Dummy callback type for type deduction only.
     // Never actually used in operation.
     struct dummy_callback {
@@ -72,11 +91,52 @@ namespace iouxx::details {
     // Forward declaration
     inline std::uint32_t get_native_handle(const ring& r) noexcept;
 
+    // Intrusive node of ready queue of a ring.
+    struct ready_node {
+        ready_node* next = nullptr;
+        std::coroutine_handle<> handle = nullptr;
+    };
+
+    // Forward declaration
+    inline bool defer_resume(ring& r, ready_node& node) noexcept;
+
+    // Shared by awaiter operations awaited together (when_all / when_any).
+    // The awaiting coroutine is resumed when the last one arrives.
+    struct join_state {
+        using first_handler_type = void (*)(join_state&, std::size_t) noexcept;
+        static constexpr std::size_t none = static_cast<std::size_t>(-1);
+
+        // Returns true if index is the last one to arrive.
+        bool arrive(std::size_t index) noexcept {
+            if (first == none) {
+                first = index;
+                if (on_first) {
+                    on_first(*this, index);
+                }
+            }
+            return --remaining == 0;
+        }
+
+        std::coroutine_handle<> handle = nullptr;
+        std::size_t remaining = 0;
+        std::size_t first = none;
+        first_handler_type on_first = nullptr;
+    };
+
+    // Grants library facilities built on top of operations (e.g. when_all,
+    // with_deadline) access to operation internals.
+    struct operation_access;
+
     template<typename Promise>
     concept has_unhandled_stopped = requires (Promise& p) {
         { p.unhandled_stopped() } noexcept -> std::convertible_to<std::coroutine_handle<>>;
     };
 
+    template<typename Promise>
+    concept has_stop_token = requires (Promise& p) {
+        { p.get_stop_token() } noexcept -> std::convertible_to<std::stop_token>;
+    };
+
     template<typename Promise>
     constexpr std::coroutine_handle<Promise> handle_cast(std::coroutine_handle<> h) noexcept {
         return std::coroutine_handle<Promise>::from_address(h.address());
@@ -103,6 +163,11 @@ namespace iouxx::details {
         ));
     }
 
+    // Opcode support only depends on running kernel,
+    // once verified on any ring, no need to test again.
+    template<std::uint8_t Opcode>
+    inline constinit std::atomic<bool> opcode_verified = false;
+
     inline ::__u64 to_tag(iouops::operation_base* cb) noexcept {
         static_assert(sizeof(::__u64) >= sizeof(std::uintptr_t));
         return static_cast<::__u64>(reinterpret_cast<std::uintptr_t>(cb));
@@ -145,15 +210,29 @@ namespace iouxx::inline iouops {
         using result_type = Result;
         using expected_type = std::expected<result_type, std::error_code>;
     public:
+        // Inside dispatch pass of owner ring, the coroutine is queued and
+        // resumed after the pass, so await chains do not nest on the stack
+        // of dispatcher. Otherwise it is resumed inline.
         void operator()(expected_type res) IOUXX_CALLBACK_NOEXCEPT {
-            if (cancel_handler && !res && res.error() == std::errc::operation_canceled) {
-                cancel_handler(handle).resume(); // should not throw
+            if (join) {
+                // Cancellation is reported as result of the joined operation
+                *result = std::move(res);
+                if (!join->arrive(join_index)) {
+                    return;
+                }
+                node.handle = join->handle;
+            } else if (cancel_handler && !res && res.error() == std::errc::operation_canceled) {
+                node.handle = cancel_handler(handle);
             } else {
                 *result = std::move(res);
-                // if the outest coroutine of current coroutine stack is a
-                // 'propagate to scheduler' coroutine, this may eventually throw
-                handle.resume();
+                node.handle = handle;
             }
+            if (owner && details::defer_resume(*owner, node)) {
+                return;
+            }
+            // if the outest coroutine of current coroutine stack is a
+            // 'propagate to scheduler' coroutine, this may eventually throw
+            node.handle.resume();
         }
 
     private:
@@ -161,6 +240,10 @@ namespace iouxx::inline iouops {
         expected_type* result = nullptr;
         details::cancel_handler_type cancel_handler = nullptr;
         std::coroutine_handle<> handle = nullptr;
+        ring* owner = nullptr;
+        details::ready_node node;
+        details::join_state* join = nullptr;
+        std::size_t join_index = 0;
     };
 
     template<template<typename...> class Operation>
@@ -251,15 +334,94 @@ namespace iouxx::inline iouops {
         operation_base(operation_base&&) = delete;
         operation_base& operator=(operation_base&&) = delete;
 
+        // Returns nullptr if SQ is full even after flushing, see ring::get_sqe().
         template<operation Self>
         ::io_uring_sqe* to_sqe(this Self& self) noexcept {
-            ::io_uring_sqe* sqe = ::io_uring_get_sqe(self.ring_ptr->native());
+            ::io_uring_sqe* sqe = self.ring_ptr->get_sqe();
             if (!sqe) return nullptr;
-            self.build(sqe); // Provided by derived class
-            ::io_uring_sqe_set_data(sqe, static_cast<operation_base*>(&self));
+            self.fill_sqe(sqe);
             return sqe;
         }
 
+        // Do not post CQE if the operation succeeds (IOSQE_CQE_SKIP_SUCCESS),
+        // callback is then only invoked on failure.
+        // Ignored if the ring does not support it.
+        // Note: operation still need to outlive its possible failure completion.
+        //  Once used on a ring, drain() fails on that ring (EOPNOTSUPP).
+        template<operation Self>
+            requires (!syncwait_operation<Self>) && (!awaiter_operation<Self>)
+        Self& skip_success_cqe(this Self& self, bool enable = true) noexcept {
+            self.skip_success = enable;
+            return self;
+        }
+
+        // Always issue the operation asynchronously (IOSQE_ASYNC),
+        // skipping the inline attempt. Useful for operations known to block,
+        // e.g. buffered read of cold files.
+        template<operation Self>
+        Self& async(this Self& self, bool enable = true) noexcept {
+            self.set_extra_flag(IOSQE_ASYNC, enable);
+            return self;
+        }
+
+        // Start the operation only after all previously submitted ones
+        // complete (IOSQE_IO_DRAIN).
+        // Note: not allowed on a ring where CQE skip has been used.
+        template<operation Self>
+        Self& drain(this Self& self, bool enable = true) noexcept {
+            self.set_extra_flag(IOSQE_IO_DRAIN, enable);
+            return self;
+        }
+
+        // Issue the operation with credentials registered by
+        // ring::register_personality(). Set to 0 to use current credentials.
+        template<operation Self>
+        Self& personality(this Self& self, std::uint16_t id) noexcept {
+            self.personality_id = id;
+            return self;
+        }
+
+        // Run feature test, then get a SQE from ring and build operation into it.
+        // The SQE is not submitted, it will be submitted with next submission
+        // of the ring (e.g. ring::flush()).
+        // Parked operations of the ring are flushed first to keep submission
+        // order, fails with resource_unavailable_try_again if they are stuck.
+        template<operation Self>
+        auto prepare(this Self& self) noexcept
+            -> std::expected<::io_uring_sqe*, std::error_code> {
+            if (std::error_code test = self.feature_test()) {
+                return std::unexpected(test);
+            }
+            if (self.ring_ptr->parked_operations() != 0) {
+                if (std::error_code ec = self.ring_ptr->flush()) {
+                    return std::unexpected(ec);
+                }
+                if (self.ring_ptr->parked_operations() != 0) {
+                    return utility::fail(std::errc::resource_unavailable_try_again);
+                }
+            }
+            if (::io_uring_sqe* sqe = self.to_sqe()) {
+                return sqe;
+            }
+            return utility::fail(std::errc::resource_unavailable_try_again);
+        }
+
+        // Enable feature test by define IOUXX_CONFIG_ENABLE_FEATURE_TESTS.
+        // Always returns success if feature test is disabled.
+        template<operation Self>
+        std::error_code feature_test(this Self& self) noexcept {
+#if defined(IOUXX_IORING_FEATURE_TESTS_ENABLED) && IOUXX_IORING_FEATURE_TESTS_ENABLED == 1
+            auto& verified = details::opcode_verified<Self::opcode>;
+            if (!verified.load(std::memory_order_relaxed)) {
+                if (!self.ring_ptr->opcode_supported(Self::opcode)) {
+                    return std::make_error_code(std::errc::function_not_supported);
+                }
+                verified.store(true, std::memory_order_relaxed);
+            }
+#endif // IOUXX_IORING_FEATURE_TESTS_ENABLED
+            return std::error_code();
+        }
+
         template<operation Self>
             requires (!syncwait_operation<Self>) && (!awaiter_operation<Self>) 
         std::error_code submit(this Self& self) noexcept {
@@ -295,26 +457,74 @@ namespace iouxx::inline iouops {
 
             constexpr bool await_ready() const noexcept { return false; }
 
+            // Note: if the ring is in deferred submission mode, the operation
+            //  is only prepared here, and submitted on next flush of the ring.
+            // If a stop token is given (or provided by the caller promise via
+            // get_stop_token()), a stop request cancels the operation in flight.
             template<typename CallerPromise>
             bool await_suspend(std::coroutine_handle<CallerPromise> handle) noexcept {
+                if constexpr (details::has_stop_token<CallerPromise>) {
+                    if (!token) {
+                        token = handle.promise().get_stop_token();
+                    }
+                }
+                if (token && token->stop_requested()) {
+                    // Never submitted
+                    result = utility::fail(std::errc::operation_canceled);
+                    return false;
+                }
                 self.setup_awaiter_callback(handle, this->result);
                 if (std::error_code res = self.do_submit()) {
                     // fail to submit, resume immediately
                     result = std::unexpected(res);
                     return false;
-                } else {
-                    return true; // suspend
                 }
+                if (token && token->stop_possible()) {
+                    owner_thread = std::this_thread::get_id();
+                    // Invoked at once if stop is requested meanwhile
+                    canceller.emplace(std::move(*token), stop_canceller{ this });
+                }
+                return true; // suspend
             }
 
-            expected_type await_resume() noexcept { return std::move(result); }
+            expected_type await_resume() noexcept {
+                // Waits for a running stop callback on another thread
+                canceller.reset();
+                return std::move(result);
+            }
 
         private:
             friend operation_base;
             explicit operation_awaiter(Self& self) noexcept : self(self) {}
 
+            operation_awaiter(Self& self, std::stop_token token) noexcept :
+                self(self), token(std::move(token))
+            {}
+
+            struct stop_canceller {
+                operation_awaiter* awaiter;
+                void operator()() const noexcept {
+                    awaiter->cancel();
+                }
+            };
+
+            // Best effort, the operation may complete normally anyway.
+            // On the ring thread, cancel request goes through SQ. Otherwise
+            // SQ must not be touched, sync cancel is issued with real ring fd.
+            void cancel() noexcept {
+                iouxx::ring& ring = self.owner_ring();
+                if (std::this_thread::get_id() == owner_thread) {
+                    [[maybe_unused]] std::error_code ec = ring.cancel_async(self.identifier());
+                } else {
+                    [[maybe_unused]] std::error_code ec = ring.cancel_sync(self.identifier());
+                }
+            }
+
             Self& self;
             expected_type result = std::unexpected(std::error_code());
+            std::optional<std::stop_token> token;
+            std::optional<std::stop_callback<stop_canceller>> canceller;
+            std::thread::id owner_thread;
         };
 
         template<awaiter_operation Self>
@@ -322,6 +532,15 @@ namespace iouxx::inline iouops {
             return operation_awaiter<Self>(self);
         }
 
+        // Await the operation, cancel it in flight once stop is requested on
+        // token. Takes precedence over stop token of the caller promise.
+        // Example:
+        //   auto res = co_await op.with_stop_token(source.get_token());
+        template<awaiter_operation Self>
+        operation_awaiter<Self> with_stop_token(this Self& self, std::stop_token token) noexcept {
+            return operation_awaiter<Self>(self, std::move(token));
+        }
+
         void callback(int ev, std::int32_t cqe_flags) & IOUXX_CALLBACK_NOEXCEPT {
             do_callback_ptr(this, ev, cqe_flags);
         }
@@ -330,6 +549,10 @@ namespace iouxx::inline iouops {
             return operation_identifier(this);
         }
 
+        iouxx::ring& owner_ring() const noexcept {
+            return *ring_ptr;
+        }
+
     protected:
         // Note:
         // Override method will receive raw error code from kernel, because:
@@ -342,6 +565,14 @@ namespace iouxx::inline iouops {
         using callback_wrapper_type =
             void (*)(operation_base*, int, std::int32_t) IOUXX_CALLBACK_NOEXCEPT;
 
+        // Used by ring to build parked operations later.
+        using fill_sqe_wrapper_type = void (*)(operation_base*, ::io_uring_sqe*) noexcept;
+
+        template<operation Derived>
+        static void fill_sqe_wrapper(operation_base* base, ::io_uring_sqe* sqe) noexcept {
+            static_cast<Derived*>(base)->fill_sqe(sqe);
+        }
+
         template<operation Derived>
         static void callback_wrapper(operation_base* base, int ev, std::int32_t cqe_flags)
             IOUXX_CALLBACK_NOEXCEPT_IF(utility::eligible_nothrow_callback<
@@ -353,40 +584,69 @@ namespace iouxx::inline iouops {
         // Type erasure here
         template<operation Derived>
         explicit operation_base(operation_t<Derived>, ring& ring) noexcept
-            : do_callback_ptr(&callback_wrapper<Derived>), ring_ptr(&ring)
+            : do_callback_ptr(&callback_wrapper<Derived>),
+            fill_sqe_ptr(&fill_sqe_wrapper<Derived>), ring_ptr(&ring)
         {}
 
-        // Enable feature test by define IOUXX_CONFIG_ENABLE_FEATURE_TESTS.
-        // Always returns success if feature test is disabled.
         template<operation Self>
-        std::error_code feature_test(this Self& self) noexcept {
-#if defined(IOUXX_IORING_FEATURE_TESTS_ENABLED) && IOUXX_IORING_FEATURE_TESTS_ENABLED == 1
-            if (!::io_uring_opcode_supported(self.ring_ptr->ring_probe(),
-                Self::opcode)) {
-                return std::make_error_code(std::errc::function_not_supported);
+        std::error_code do_submit(this Self& self) noexcept {
+            if (std::error_code test = self.feature_test()) {
+                return test;
             }
-#endif // IOUXX_IORING_FEATURE_TESTS_ENABLED
-            return std::error_code();
+            // Feature test passed, parked by ring if SQ is full
+            return self.ring_ptr->submit(static_cast<operation_base&>(self));
         }
 
         template<operation Self>
-        std::error_code do_submit(this Self& self) noexcept {
-            if (std::error_code test = self.feature_test()) {
-                return test;
+        void fill_sqe(this Self& self, ::io_uring_sqe* sqe) noexcept {
+            self.build(sqe); // Provided by derived class
+            sqe->flags |= self.extra_flags;
+            if (self.skip_success
+                && self.ring_ptr->test_feature(iouxx::ring::feature::cqe_skip)) {
+                sqe->flags |= IOSQE_CQE_SKIP_SUCCESS;
+            }
+            if (self.personality_id != 0) {
+                sqe->personality = self.personality_id;
             }
-            // Feature test passed
-            return self.ring_ptr->submit(self.to_sqe());
+            ::io_uring_sqe_set_data(sqe, static_cast<operation_base*>(&self));
         }
 
         template<awaiter_operation Self, typename CallerPromise, typename Result>
         void setup_awaiter_callback(this Self& self,
             std::coroutine_handle<CallerPromise> handle,
-            std::expected<Result, std::error_code>& result) noexcept {
+            std::expected<Result, std::error_code>& result,
+            bool stoppable = true) noexcept {
             auto& cb = self.callback;
             cb.handle = handle;
             cb.result = &result;
+            cb.owner = self.ring_ptr;
+            cb.join = nullptr;
+            cb.cancel_handler = nullptr;
             if constexpr (details::has_unhandled_stopped<CallerPromise>) {
-                cb.cancel_handler = &details::cancel_handler<CallerPromise>;
+                if (stoppable) {
+                    cb.cancel_handler = &details::cancel_handler<CallerPromise>;
+                }
+            }
+        }
+
+        template<awaiter_operation Self, typename Result>
+        void setup_join_callback(this Self& self,
+            details::join_state& join, std::size_t index,
+            std::expected<Result, std::error_code>& result) noexcept {
+            auto& cb = self.callback;
+            cb.handle = nullptr;
+            cb.result = &result;
+            cb.cancel_handler = nullptr;
+            cb.owner = self.ring_ptr;
+            cb.join = &join;
+            cb.join_index = index;
+        }
+
+        void set_extra_flag(std::uint8_t flag, bool enable) noexcept {
+            if (enable) {
+                extra_flags |= flag;
+            } else {
+                extra_flags &= static_cast<std::uint8_t>(~flag);
             }
         }
 
@@ -409,8 +669,16 @@ namespace iouxx::inline iouops {
         template<typename Operation>
         friend consteval bool details::test_operation_members() noexcept;
 
+        friend iouxx::ring;
+        friend details::operation_access;
+
         callback_wrapper_type do_callback_ptr = nullptr;
+        fill_sqe_wrapper_type fill_sqe_ptr = nullptr;
         ring* ring_ptr = nullptr;
+        operation_base* next_parked = nullptr;
+        bool skip_success = false;
+        std::uint8_t extra_flags = 0;
+        std::uint16_t personality_id = 0;
     };
 
     template<template<typename...> class Operation, typename Callback, typename... Args>
@@ -507,8 +775,11 @@ namespace iouxx {
             return cb;
         }
 
+        // Does nothing for results not from an operation.
         void callback() const IOUXX_CALLBACK_NOEXCEPT {
-            cb->callback(res, cqe_flags);
+            if (cb) {
+                cb->callback(res, cqe_flags);
+            }
         }
 
         void operator()() const IOUXX_CALLBACK_NOEXCEPT {
@@ -535,8 +806,8 @@ namespace iouxx {
     {
     public:
         ring_option() = default;
-        ring_option(ring_option&) = default;
-        ring_option& operator=(ring_option&) = default;
+        ring_option(const ring_option&) = default;
+        ring_option& operator=(const ring_option&) = default;
 
         // Note:
         //  Use setup_sqpoll() instead if you want to enable SQPOLL.
@@ -595,6 +866,24 @@ namespace iouxx {
             return *this;
         }
 
+        // Defer submission: ring::submit() only prepares the SQE,
+        // all pending SQEs are submitted by ring::flush() with one syscall.
+        // See ring::set_deferred_submit().
+        ring_option& deferred_submit(bool enable = true) noexcept {
+            this->deferred = enable;
+            return *this;
+        }
+
+        // Register the ring fd after setup (disabled by default), which saves
+        // a fd lookup on every io_uring_enter. Failure is ignored.
+        // Note: registered ring fd belongs to the thread creating the ring,
+        //  only enable this if the ring is only submitted to, waited on and
+        //  stopped from that thread. See ring::register_ring_fd().
+        ring_option& register_ring_fd(bool enable = true) noexcept {
+            this->register_fd = enable;
+            return *this;
+        }
+
     private:
         friend ring;
         ::io_uring_params to_params() const noexcept {
@@ -639,6 +928,8 @@ namespace iouxx {
         std::uint32_t cq_entries = 0;
         std::uint32_t sq_thread_cpu = 0;
         std::uint32_t sq_thread_idle = 0;
+        bool deferred = false;
+        bool register_fd = false;
     };
 
     class ring
@@ -658,8 +949,30 @@ namespace iouxx {
         ring(ring&& other) = delete;
         ring& operator=(ring&& other) = delete;
 
+        // Note: operations in flight stay bound to the ring object they were
+        //  made with, swap only when nothing is in flight. Parked operations
+        //  have not reached the kernel yet, they move with the queue.
         void swap(ring& other) noexcept {
+            IOUXX_ASSERT(!dispatching && !other.dispatching);
             std::ranges::swap(raw_ring, other.raw_ring);
+            std::ranges::swap(probe, other.probe);
+            // Buffer rings are registered on the io_uring instance
+            std::ranges::swap(buffer_ring_pages, other.buffer_ring_pages);
+            rebind_buffer_rings();
+            other.rebind_buffer_rings();
+            std::ranges::swap(parked_head, other.parked_head);
+            std::ranges::swap(parked_tail, other.parked_tail);
+            std::ranges::swap(parked_count, other.parked_count);
+            rebind_parked();
+            other.rebind_parked();
+            std::ranges::swap(deferred_submission, other.deferred_submission);
+            // Opcode cache describes the probe
+            std::ranges::swap(supported_opcodes, other.supported_opcodes);
+            // Registered fd index lives in raw_ring
+            std::ranges::swap(ring_fd_registered, other.ring_fd_registered);
+            std::ranges::swap(run_stop_requested, other.run_stop_requested);
+            std::ranges::swap(ready_head, other.ready_head);
+            std::ranges::swap(ready_tail, other.ready_tail);
         }
 
         ~ring() { exit(); }
@@ -778,16 +1091,69 @@ namespace iouxx {
             return utility::make_system_error_code(-ev);
         }
 
+        // Parked operations complete with operation_canceled before the ring
+        // is torn down, their callbacks run (and awaiters resume) inline.
         void exit() noexcept {
             if (valid()) {
                 [[maybe_unused]] std::error_code res = stop();
                 IOUXX_ASSERT(res != utility::fail_invalid_argument().error());
+                // Parked operations are never submitted, complete them
+                // while the ring is still usable by their callbacks, and
+                // resume coroutines queued meanwhile (or before, if exiting
+                // during dispatch), which may park more operations
+                while (parked_head || ready_head) {
+                    while (parked_head) {
+                        operation_base* op = parked_head;
+                        unlink_parked(*op, nullptr);
+                        op->callback(-ECANCELED, 0);
+                    }
+                    run_ready();
+                }
                 probe.reset();
-                buffer_rings.clear();
-                buffer_rings.resize(buffer_ring_size_max);
+                supported_opcodes.reset();
+                // Buffer rings must be freed before the ring itself
+                for (auto& page : buffer_ring_pages) {
+                    page.reset();
+                }
+                // Registered ring fd is released by liburing
                 ::io_uring_queue_exit(&raw_ring);
                 raw_ring = invalid_ring();
+                ring_fd_registered = false;
+            }
+        }
+
+        // Register the ring fd in the calling thread, so that io_uring_enter
+        // looks up ring by index. native_handle() is not affected.
+        // Note: after registration, the ring must only be entered from
+        //  the registering thread.
+        std::error_code register_ring_fd() & noexcept {
+            IOUXX_ASSERT(valid());
+            if (ring_fd_registered) {
+                return std::error_code();
+            }
+            int ev = ::io_uring_register_ring_fd(native());
+            if (ev < 0) {
+                return utility::make_system_error_code(-ev);
+            }
+            ring_fd_registered = true;
+            return std::error_code();
+        }
+
+        std::error_code unregister_ring_fd() & noexcept {
+            IOUXX_ASSERT(valid());
+            if (!ring_fd_registered) {
+                return std::error_code();
+            }
+            int ev = ::io_uring_unregister_ring_fd(native());
+            if (ev < 0) {
+                return utility::make_system_error_code(-ev);
             }
+            ring_fd_registered = false;
+            return std::error_code();
+        }
+
+        bool is_ring_fd_registered() const noexcept {
+            return ring_fd_registered;
         }
 
         std::error_code start_from_disabled() & noexcept {
@@ -856,20 +1222,119 @@ namespace iouxx {
             return operation_type(*this, std::in_place_type<callback_type>);
         }
 
+        // In deferred submission mode, the SQE is only left in SQ,
+        // and will be submitted on next flush().
         std::error_code submit(::io_uring_sqe* sqe) noexcept {
             IOUXX_ASSERT(valid());
             if (!sqe) {
                 return std::make_error_code(std::errc::resource_unavailable_try_again);
             }
-            int ev = ::io_uring_submit(native());
-            if (ev < 0) {
-                return utility::make_system_error_code(-ev);
+            if (deferred_submission) {
+                return std::error_code();
+            }
+            return flush();
+        }
+
+        // Submit all pending SQEs with one syscall.
+        // Parked operations are moved into SQ as space frees up,
+        // which may take more than one syscall.
+        std::error_code flush() noexcept {
+            IOUXX_ASSERT(valid());
+            do {
+                unpark();
+                int ev = ::io_uring_submit(native());
+                if (ev < 0) {
+                    return utility::make_system_error_code(-ev);
+                }
+            } while (parked_head && ::io_uring_sq_space_left(native()) != 0);
+            return std::error_code();
+        }
+
+        // Request cancellation of an in-flight operation of this ring, without
+        // tracking the request itself: its CQE carries no operation and is
+        // skipped by the dispatcher.
+        // The target completes with operation_canceled if it is cancelled.
+        // A parked target never reaches the kernel, it is completed at once.
+        std::error_code cancel_async(operation_identifier id) noexcept {
+            IOUXX_ASSERT(valid());
+            operation_base* prev = nullptr;
+            for (operation_base* op = parked_head; op; prev = op, op = op->next_parked) {
+                if (op->identifier() == id) {
+                    unlink_parked(*op, prev);
+                    op->callback(-ECANCELED, 0);
+                    return std::error_code();
+                }
+            }
+            // Otherwise the target is already ahead of parked operations
+            ::io_uring_sqe* sqe = get_sqe();
+            if (!sqe) {
+                return std::make_error_code(std::errc::resource_unavailable_try_again);
+            }
+            ::io_uring_prep_cancel64(sqe, id.user_data64(), 0);
+            ::io_uring_sqe_set_data64(sqe, 0);
+            return submit(sqe);
+        }
+
+        // Like cancel_async, but safe to call from any thread: no SQE is
+        // involved, and the real ring fd is used. Blocks until the operation
+        // is cancelled or timed out. Zero timeout means waiting without timeout.
+        std::error_code cancel_sync(operation_identifier id,
+            std::chrono::nanoseconds timeout = {}) noexcept {
+            IOUXX_ASSERT(valid());
+            ::io_uring_sync_cancel_reg reg = {};
+            reg.addr = id.user_data64();
+            if (timeout.count() != 0) {
+                reg.timeout = utility::to_kernel_timespec(timeout);
+            } else {
+                reg.timeout = { -1, -1 };
+            }
+            int ev = ::io_uring_register(static_cast<unsigned>(native_handle()),
+                IORING_REGISTER_SYNC_CANCEL, &reg, 1);
+            return utility::make_system_error_code(ev < 0 ? -ev : 0);
+        }
+
+        // Get a free SQE. If SQ is full, pending SQEs are submitted to make room.
+        // Returns nullptr if SQ is still full (e.g. SQPOLL thread is behind).
+        ::io_uring_sqe* get_sqe() noexcept {
+            IOUXX_ASSERT(valid());
+            if (::io_uring_sqe* sqe = ::io_uring_get_sqe(native())) {
+                return sqe;
+            }
+            if (::io_uring_submit(native()) < 0) {
+                return nullptr;
+            }
+            return ::io_uring_get_sqe(native());
+        }
+
+        // Number of SQEs prepared but not yet submitted.
+        std::size_t pending_submissions() const noexcept {
+            IOUXX_ASSERT(valid());
+            return ::io_uring_sq_ready(&raw_ring);
+        }
+
+        // Number of operations waiting for SQ space.
+        std::size_t parked_operations() const noexcept {
+            return parked_count;
+        }
+
+        bool deferred_submit() const noexcept {
+            return deferred_submission;
+        }
+
+        // Switch between deferred and immediate submission mode.
+        // Switching to immediate mode flushes all pending SQEs.
+        std::error_code set_deferred_submit(bool enable) noexcept {
+            IOUXX_ASSERT(valid());
+            deferred_submission = enable;
+            if (!enable && pending_submissions() != 0) {
+                return flush();
             }
             return std::error_code();
         }
 
         std::expected<operation_result, std::error_code> fetch_result() noexcept {
             IOUXX_ASSERT(valid());
+            IOUXX_ASSERT(!dispatching); // Reaping inside run_completions()
             ::io_uring_cqe* cqe = nullptr;
             int ev = ::io_uring_peek_cqe(native(), &cqe);
             if (ev < 0) {
@@ -883,9 +1348,16 @@ namespace iouxx {
         auto wait_for_result(std::chrono::nanoseconds timeout = {})
             noexcept -> std::expected<operation_result, std::error_code> {
             IOUXX_ASSERT(valid());
+            IOUXX_ASSERT(!dispatching); // Reaping inside run_completions()
             ::io_uring_cqe* cqe = nullptr;
             int ev = 0;
-            if (timeout.count() != 0) {
+            unpark();
+            if (pending_submissions() != 0) {
+                // Submit pending SQEs and wait in one syscall
+                auto ts = utility::to_kernel_timespec(timeout);
+                ev = ::io_uring_submit_and_wait_timeout(native(), &cqe, 1,
+                    timeout.count() != 0 ? &ts : nullptr, nullptr);
+            } else if (timeout.count() != 0) {
                 auto ts = utility::to_kernel_timespec(timeout);
                 ev = ::io_uring_wait_cqe_timeout(native(), &cqe, &ts);
             } else {
@@ -899,6 +1371,105 @@ namespace iouxx {
             return result;
         }
 
+        static constexpr std::size_t completion_batch_size = 32;
+
+        // Reap and dispatch up to max_completions available CQEs without waiting.
+        // CQEs are peeked in batches, and CQ head is advanced once per batch.
+        // Coroutines completed in the pass are resumed after it in completion
+        // order (see awaiter_callback).
+        // In deferred submission mode, SQEs submitted by callbacks are flushed
+        // at the end of the dispatch pass.
+        // Returns number of reaped CQEs.
+        // Note: callbacks may submit new operations, but must not reap this ring.
+        auto run_completions(std::size_t max_completions = std::numeric_limits<std::size_t>::max())
+            IOUXX_CALLBACK_NOEXCEPT -> std::expected<std::size_t, std::error_code> {
+            IOUXX_ASSERT(valid());
+            IOUXX_ASSERT(!dispatching);
+            std::size_t total = 0;
+            {
+                dispatching = true;
+                utility::defer reset{[this]() noexcept { dispatching = false; }};
+                std::array<::io_uring_cqe*, completion_batch_size> cqes;
+                while (total < max_completions) {
+                    const auto want = static_cast<unsigned>(
+                        std::min(max_completions - total, cqes.size()));
+                    const unsigned count =
+                        ::io_uring_peek_batch_cqe(native(), cqes.data(), want);
+                    if (count == 0) {
+                        break;
+                    }
+                    unsigned seen = 0;
+                    // Also advance on exception, thrown CQE is consumed
+                    utility::defer advance{[this, &seen]() noexcept {
+                        ::io_uring_cq_advance(native(), seen);
+                    }};
+                    while (seen < count) {
+                        operation_result result(cqes[seen++]);
+                        if (result) {
+                            result.callback();
+                        }
+                    }
+                    total += count;
+                }
+            }
+            run_ready();
+            if ((deferred_submission && pending_submissions() != 0) || parked_head) {
+                if (std::error_code ec = flush()) {
+                    return std::unexpected(ec);
+                }
+            }
+            return total;
+        }
+
+        // Submit all pending SQEs and wait for at least min_completions CQEs
+        // in one syscall, then dispatch all available CQEs.
+        // Zero timeout means waiting without timeout.
+        // Returns number of reaped CQEs, which may be less than min_completions
+        // if timed out or interrupted.
+        auto run_once(unsigned min_completions = 1, std::chrono::nanoseconds timeout = {})
+            IOUXX_CALLBACK_NOEXCEPT -> std::expected<std::size_t, std::error_code> {
+            IOUXX_ASSERT(valid());
+            IOUXX_ASSERT(!dispatching);
+            ::io_uring_cqe* cqe = nullptr;
+            auto ts = utility::to_kernel_timespec(timeout);
+            unpark();
+            int ev = ::io_uring_submit_and_wait_timeout(native(), &cqe, min_completions,
+                timeout.count() != 0 ? &ts : nullptr, nullptr);
+            if (ev < 0 && ev != -ETIME && ev != -EINTR) {
+                return utility::fail(-ev);
+            }
+            return run_completions();
+        }
+
+        // Run event loop until stop_run() is called (usually by a callback).
+        std::error_code run() IOUXX_CALLBACK_NOEXCEPT {
+            return run_until([]() static noexcept { return false; });
+        }
+
+        // Run event loop until given duration elapsed or stop_run() is called.
+        std::error_code run_for(std::chrono::nanoseconds duration) IOUXX_CALLBACK_NOEXCEPT {
+            using clock = std::chrono::steady_clock;
+            return run_until([]() static noexcept { return false; },
+                clock::now() + duration);
+        }
+
+        // Run event loop until pred() returns true or stop_run() is called.
+        // pred is checked before each loop turn.
+        template<std::predicate<> Pred>
+        std::error_code run_until(Pred&& pred) IOUXX_CALLBACK_NOEXCEPT {
+            return run_until(std::forward<Pred>(pred),
+                std::chrono::steady_clock::time_point::max());
+        }
+
+        // Request running event loop to exit after current loop turn.
+        void stop_run() noexcept {
+            run_stop_requested = true;
+        }
+
+        bool stop_run_requested() const noexcept {
+            return run_stop_requested;
+        }
+
         static constexpr std::size_t buffer_ring_size_max = 65536;
 
         std::error_code register_buffer_table(std::size_t size) noexcept {
@@ -907,6 +1478,14 @@ namespace iouxx {
             return utility::make_system_error_code(-ev);
         }
 
+        // Unregister the whole buffer table, in-flight operations using
+        // registered buffers still complete normally.
+        std::error_code unregister_buffer_table() noexcept {
+            IOUXX_ASSERT(valid());
+            int ev = ::io_uring_unregister_buffers(native());
+            return utility::make_system_error_code(-ev);
+        }
+
         // Warning: the unreg_op need to outlive the buffer usage.
         template<details::buffer_range Buffers, typename UnregistrationOperation>
             requires (utility::is_specialization_of_v<iouops::ring_management_operation, UnregistrationOperation>)
@@ -1001,6 +1580,21 @@ namespace iouxx {
             return utility::make_system_error_code(-ev);
         }
 
+        // Counters of a buffer group, see buffer_group::stats().
+        // Consumption is only seen when its CQE is reaped, so available
+        // is an upper bound of what the kernel can still select.
+        struct buffer_group_stats {
+            std::uint32_t buffers = 0; // inserted into the group
+            std::uint32_t leased = 0; // selected by kernel, not recycled yet
+            std::uint32_t pending = 0; // recycled, not published to kernel yet
+            std::uint32_t min_available = 0; // lowest available seen
+            std::uint64_t low_watermark_hits = 0; // times available reached low watermark
+
+            std::uint32_t available() const noexcept {
+                return buffers - leased - pending;
+            }
+        };
+
     private:
         class buffer_ring
         {
@@ -1012,6 +1606,14 @@ namespace iouxx {
             buffer_ring(buffer_ring&& other) noexcept :
                 raw_ring(other.raw_ring),
                 buf_ring(std::exchange(other.buf_ring, nullptr)),
+                table(std::move(other.table)),
+                offsets(std::move(other.offsets)),
+                slots(std::move(other.slots)),
+                links(std::move(other.links)),
+                tail(std::exchange(other.tail, 0)),
+                counters(std::exchange(other.counters, {})),
+                batch(std::exchange(other.batch, 1)),
+                watermark(std::exchange(other.watermark, 0)),
                 entries(std::exchange(other.entries, 0)),
                 bgid(std::exchange(other.bgid, -1))
             {}
@@ -1024,6 +1626,14 @@ namespace iouxx {
             void swap(buffer_ring& other) noexcept {
                 std::ranges::swap(raw_ring, other.raw_ring);
                 std::ranges::swap(buf_ring, other.buf_ring);
+                std::ranges::swap(table, other.table);
+                std::ranges::swap(offsets, other.offsets);
+                std::ranges::swap(slots, other.slots);
+                std::ranges::swap(links, other.links);
+                std::ranges::swap(tail, other.tail);
+                std::ranges::swap(counters, other.counters);
+                std::ranges::swap(batch, other.batch);
+                std::ranges::swap(watermark, other.watermark);
                 std::ranges::swap(entries, other.entries);
                 std::ranges::swap(bgid, other.bgid);
             }
@@ -1038,13 +1648,119 @@ namespace iouxx {
                 return buf_ring != nullptr;
             }
 
+            // Follow the io_uring instance to its new owner, see ring::swap().
+            void rebind(::io_uring* owner) noexcept {
+                raw_ring = owner;
+            }
+
             // User has to ensure total amount of added buffers does not exceed the ring capacity.
             template<utility::buffer_like Buffer>
             void insert(Buffer&& buffer, std::uint16_t bid) noexcept {
                 auto buf = utility::to_buffer(std::forward<Buffer>(buffer));
-                ::io_uring_buf_ring_add(buf_ring, buf.data(), buf.size(), bid,
-                    ::io_uring_buf_ring_mask(entries), 0);
-                ::io_uring_buf_ring_advance(buf_ring, 1);
+                IOUXX_ASSERT(bid < entries);
+                commit();
+                table[bid] = { .iov_base = buf.data(), .iov_len = buf.size() };
+                add(bid, 0);
+                publish(1);
+                ++counters.buffers;
+                counters.min_available = counters.available();
+            }
+
+            // A buffer is selected by kernel, and leased to user.
+            void take() noexcept {
+                ++counters.leased;
+                const std::uint32_t available = counters.available();
+                counters.min_available = std::min(counters.min_available, available);
+                if (available <= watermark) {
+                    ++counters.low_watermark_hits;
+                    commit();
+                }
+            }
+
+            // Give a buffer selected by kernel back to the ring, as a whole.
+            // Recycled buffers are published in batches, or at once if
+            // the ring is about to run dry.
+            void recycle(std::uint16_t bid) noexcept {
+                IOUXX_ASSERT(bid < entries);
+                add(bid, counters.pending);
+                ++counters.pending;
+                if (counters.leased != 0) {
+                    --counters.leased;
+                }
+                if (counters.pending >= batch || counters.available() <= watermark) {
+                    commit();
+                }
+            }
+
+            // Publish pending recycled buffers to kernel.
+            void commit() noexcept {
+                if (counters.pending != 0) {
+                    publish(counters.pending);
+                    counters.pending = 0;
+                }
+            }
+
+            // Bid of the ring entry following the one bid was added to.
+            // A bundle takes consecutive entries, so its buffers are walked
+            // from the first bid of its CQE. The link stays valid while bid
+            // is out of the ring, whatever order completions of ops sharing
+            // the group arrive in.
+            std::uint16_t next(std::uint16_t bid) const noexcept {
+                IOUXX_ASSERT(bid < entries);
+                return links[bid];
+            }
+
+            // Buffers covering len bytes from first are sent from the group
+            // as a queue (send bundle), they are out of the group now.
+            // Returns count of them.
+            std::uint32_t dequeue(std::uint16_t first, std::size_t len) noexcept {
+                std::uint32_t n = 0;
+                for (std::uint16_t bid = first; len != 0; bid = next(bid)) {
+                    len -= std::min(len, table[bid].iov_len);
+                    ++n;
+                }
+                IOUXX_ASSERT(n <= counters.buffers);
+                counters.buffers -= n;
+                return n;
+            }
+
+            void recycle_batch(std::uint32_t n) noexcept {
+                batch = std::max<std::uint32_t>(n, 1);
+                if (counters.pending >= batch) {
+                    commit();
+                }
+            }
+
+            void low_watermark(std::uint32_t n) noexcept {
+                watermark = n;
+            }
+
+            const buffer_group_stats& stats() const noexcept {
+                return counters;
+            }
+
+            std::span<std::byte> buffer(std::uint16_t bid) const noexcept {
+                IOUXX_ASSERT(bid < entries);
+                const ::iovec& buf = table[bid];
+                return std::span(static_cast<std::byte*>(buf.iov_base), buf.iov_len);
+            }
+
+            std::uint16_t id() const noexcept {
+                return static_cast<std::uint16_t>(bgid);
+            }
+
+            bool incremental() const noexcept {
+                return offsets != nullptr;
+            }
+
+            // Incremental consumption: kernel appends to the same buffer until
+            // it is used up, userspace tracks where each chunk starts.
+            // Returns offset of the chunk of len bytes.
+            std::uint32_t consume(std::uint16_t bid, std::size_t len, bool more) noexcept {
+                IOUXX_ASSERT(incremental() && bid < entries);
+                const std::uint32_t offset = offsets[bid];
+                offsets[bid] = more ? offset + static_cast<std::uint32_t>(len) : 0;
+                return offset;
             }
 
             // User has to ensure total amount of added buffers does not exceed the ring capacity.
@@ -1054,12 +1770,16 @@ namespace iouxx {
                     std::vector<::iovec> bufs = details::to_iovecs(std::forward<Buffers>(buffers));
                     std::vector<std::uint16_t> bids(std::from_range, std::forward<Bufbids>(bufbids));
                     IOUXX_ASSERT(bufs.size() == bids.size());
+                    commit();
                     std::uint16_t total = 0;
                     for (const auto& [buf, bid] : std::views::zip(bufs, bids)) {
-                        ::io_uring_buf_ring_add(buf_ring, buf.iov_base, buf.iov_len, bid,
-                            ::io_uring_buf_ring_mask(entries), total++);
+                        IOUXX_ASSERT(bid < entries);
+                        table[bid] = buf;
+                        add(bid, total++);
                     }
-                    ::io_uring_buf_ring_advance(buf_ring, total);
+                    publish(total);
+                    counters.buffers += total;
+                    counters.min_available = counters.available();
                     return std::error_code();
                 } catch (...) {
                     return std::make_error_code(std::errc::not_enough_memory);
@@ -1069,23 +1789,71 @@ namespace iouxx {
         private:
             friend ring;
             buffer_ring(::io_uring* raw_ring, ::io_uring_buf_ring* buf_ring,
+                std::unique_ptr<::iovec[]> table, std::unique_ptr<std::uint32_t[]> offsets,
+                std::unique_ptr<std::uint16_t[]> slots, std::unique_ptr<std::uint16_t[]> links,
                 std::uint32_t entries, std::int32_t bgid) noexcept
-                : raw_ring(raw_ring), buf_ring(buf_ring), entries(entries), bgid(bgid)
+                : raw_ring(raw_ring), buf_ring(buf_ring), table(std::move(table)),
+                offsets(std::move(offsets)), slots(std::move(slots)), links(std::move(links)),
+                entries(entries), bgid(bgid)
             {}
 
+            // Add buffer at offset past the published tail, not visible to kernel
+            // until published. Entries are always added in increasing order,
+            // so the previous entry holds the bid preceding this one.
+            void add(std::uint16_t bid, std::uint32_t offset) noexcept {
+                const ::iovec& buf = table[bid];
+                ::io_uring_buf_ring_add(buf_ring, buf.iov_base, buf.iov_len, bid,
+                    ::io_uring_buf_ring_mask(entries), static_cast<int>(offset));
+                const std::uint32_t pos = tail + offset;
+                slots[pos & (entries - 1)] = bid;
+                links[slots[(pos - 1) & (entries - 1)]] = bid;
+            }
+
+            void publish(std::uint32_t n) noexcept {
+                ::io_uring_buf_ring_advance(buf_ring, static_cast<int>(n));
+                tail += n;
+            }
+
             static std::expected<buffer_ring, std::error_code> make(::io_uring* raw_ring,
                 unsigned int entries, int bgid, int flags) noexcept {
+                std::unique_ptr<::iovec[]> table;
+                std::unique_ptr<std::uint32_t[]> offsets;
+                std::unique_ptr<std::uint16_t[]> slots;
+                std::unique_ptr<std::uint16_t[]> links;
+                try {
+                    table = std::make_unique<::iovec[]>(entries);
+                    slots = std::make_unique<std::uint16_t[]>(entries);
+                    links = std::make_unique<std::uint16_t[]>(entries);
+                    if (flags & IOU_PBUF_RING_INC) {
+                        offsets = std::make_unique<std::uint32_t[]>(entries);
+                    }
+                } catch (...) {
+                    return utility::fail(std::errc::not_enough_memory);
+                }
                 int err = 0;
                 ::io_uring_buf_ring* buf_ring = 
                     ::io_uring_setup_buf_ring(raw_ring, entries, bgid, flags, &err);
                 if (err < 0) {
                     return utility::fail(-err);
                 }
-                return buffer_ring(raw_ring, buf_ring, entries, bgid);
+                return buffer_ring(raw_ring, buf_ring, std::move(table), std::move(offsets),
+                    std::move(slots), std::move(links), entries, bgid);
             }
             
             ::io_uring* raw_ring = nullptr;
             ::io_uring_buf_ring* buf_ring = nullptr;
+            // Memory of each buffer, indexed by bid
+            std::unique_ptr<::iovec[]> table;
+            // Consumed bytes of each buffer, only for incremental consumption
+            std::unique_ptr<std::uint32_t[]> offsets;
+            // Bid of each ring entry, and bid of the entry following each bid
+            std::unique_ptr<std::uint16_t[]> slots;
+            std::unique_ptr<std::uint16_t[]> links;
+            // Published position of ring
+            std::uint32_t tail = 0;
+            buffer_group_stats counters;
+            std::uint32_t batch = 1;
+            std::uint32_t watermark = 0;
             unsigned int entries = 0; // 2^n
             int bgid = -1; // 0...65535
         };
@@ -1094,6 +1862,8 @@ namespace iouxx {
         class buffer_group
         {
         public:
+            // Empty group, see operator bool.
+            buffer_group() = default;
             buffer_group(const buffer_group&) = default;
             buffer_group& operator=(const buffer_group&) = default;
 
@@ -1114,9 +1884,60 @@ namespace iouxx {
                     std::forward<Bufbids>(bufbids));
             }
 
+            // Give a buffer selected by kernel back to the group,
+            // usually done by destruction of provided_buffer.
+            void recycle(std::uint16_t bid) noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                br->recycle(bid);
+            }
+
+            // Memory of buffer inserted with given bid.
+            std::span<std::byte> buffer(std::uint16_t bid) const noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                return br->buffer(bid);
+            }
+
+            std::uint16_t id() const noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                return br->id();
+            }
+
+            // Whether buffers are consumed incrementally (IOU_PBUF_RING_INC).
+            bool incremental() const noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                return br->incremental();
+            }
+
+            // Publish recycled buffers in batches of n (at least 1),
+            // saving stores to the shared ring tail.
+            void recycle_batch(std::uint32_t n) noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                br->recycle_batch(n);
+            }
+
+            // Once available buffers drop to n, it is counted in stats,
+            // and pending recycled buffers are published at once.
+            void low_watermark(std::uint32_t n) noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                br->low_watermark(n);
+            }
+
+            // Publish pending recycled buffers to kernel now.
+            void commit() noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                br->commit();
+            }
+
+            buffer_group_stats stats() const noexcept {
+                IOUXX_ASSERT(br != nullptr);
+                return br->stats();
+            }
+
         private:
             friend ring;
-            buffer_group() = default;
+            friend provided_buffer;
+            friend provided_buffer_bundle;
+            friend details::buffer_select_base;
             explicit buffer_group(buffer_ring& br) noexcept
                 : br(&br)
             {}
@@ -1124,14 +1945,25 @@ namespace iouxx {
             buffer_ring* br = nullptr;
         };
 
+        // Buffer ids inserted into the group must be less than entries.
+        // With inc_consume (IOU_PBUF_RING_INC), a buffer is consumed in chunks
+        // by successive completions, instead of a whole buffer per completion.
         std::expected<buffer_group, std::error_code> register_buffer_group(
             std::uint16_t entries, std::uint16_t bgid, bool inc_consume = false) noexcept {
-            auto& br = buffer_rings[bgid];
+            auto& page = buffer_ring_pages[bgid / buffer_ring_page_size];
+            if (!page) {
+                try {
+                    page = std::make_unique<buffer_ring_page>();
+                } catch (...) {
+                    return utility::fail(std::errc::not_enough_memory);
+                }
+            }
+            auto& br = (*page)[bgid % buffer_ring_page_size];
             if (br.valid()) {
                 return utility::fail(std::errc::file_exists);
             }
             auto res = buffer_ring::make(native(), entries, bgid,
-                inc_consume ? 0 : IOU_PBUF_RING_INC);
+                inc_consume ? IOU_PBUF_RING_INC : 0);
             if (!res) {
                 return std::unexpected(res.error());
             }
@@ -1139,16 +1971,16 @@ namespace iouxx {
         }
 
         void unregister_buffer_group(std::uint16_t bgid) noexcept {
-            buffer_ring& br = buffer_rings[bgid];
-            if (br.valid()) {
-                br = buffer_ring{};
+            buffer_ring* br = lookup_buffer_ring(bgid);
+            if (br && br->valid()) {
+                *br = buffer_ring{};
             }
         }
 
         buffer_group find_buffer_group(std::uint16_t bgid) noexcept {
-            buffer_ring& br = buffer_rings[bgid];
-            if (br.valid()) {
-                return buffer_group(br);
+            buffer_ring* br = lookup_buffer_ring(bgid);
+            if (br && br->valid()) {
+                return buffer_group(*br);
             } else {
                 return buffer_group{};
             }
@@ -1168,6 +2000,11 @@ namespace iouxx {
             return probe.get();
         }
 
+        // Cached result of probing, no syscall or probe traversal.
+        bool opcode_supported(std::uint8_t opcode) const noexcept {
+            return supported_opcodes.test(opcode);
+        }
+
         enum class feature : std::uint32_t {
             single_mmap = IORING_FEAT_SINGLE_MMAP,
             nodrop = IORING_FEAT_NODROP,
@@ -1282,7 +2119,146 @@ namespace iouxx {
             return utility::make_system_error_code(-ev);
         }
 
+        // Register credentials of current thread,
+        // returns the id to be used by operation_base::personality().
+        auto register_personality() & noexcept
+            -> std::expected<std::uint16_t, std::error_code> {
+            IOUXX_ASSERT(valid());
+            int ev = ::io_uring_register_personality(native());
+            if (ev >= 0) {
+                return static_cast<std::uint16_t>(ev);
+            } else {
+                return utility::fail(-ev);
+            }
+        }
+
+        std::error_code unregister_personality(std::uint16_t id) & noexcept {
+            IOUXX_ASSERT(valid());
+            int ev = ::io_uring_unregister_personality(native(), id);
+            return utility::make_system_error_code(-ev);
+        }
+
     private:
+        friend operation_base;
+        friend bool details::defer_resume(ring& r, details::ready_node& node) noexcept;
+
+        // Resume queued coroutines in FIFO order.
+        // Node is unlinked before resuming, resumed coroutine may destroy it.
+        void run_ready() IOUXX_CALLBACK_NOEXCEPT {
+            while (ready_head) {
+                details::ready_node* node = std::exchange(ready_head, ready_head->next);
+                if (!ready_head) {
+                    ready_tail = nullptr;
+                }
+                node->handle.resume();
+            }
+        }
+
+        // Submit an operation. If SQ is full even after flushing, or earlier
+        // operations are still parked, the operation is parked and moved into
+        // SQ later by flush() or the event loop, keeping submission order.
+        std::error_code submit(operation_base& op) noexcept {
+            IOUXX_ASSERT(valid());
+            if (!parked_head) {
+                if (::io_uring_sqe* sqe = get_sqe()) {
+                    op.fill_sqe_ptr(&op, sqe);
+                    return submit(sqe);
+                }
+            }
+            op.next_parked = nullptr;
+            if (parked_tail) {
+                parked_tail->next_parked = &op;
+            } else {
+                parked_head = &op;
+            }
+            parked_tail = &op;
+            ++parked_count;
+            return std::error_code();
+        }
+
+        // Remove op from parked queue, prev is the one parked before it.
+        void unlink_parked(operation_base& op, operation_base* prev) noexcept {
+            IOUXX_ASSERT(prev ? prev->next_parked == &op : parked_head == &op);
+            if (prev) {
+                prev->next_parked = op.next_parked;
+            } else {
+                parked_head = op.next_parked;
+            }
+            if (parked_tail == &op) {
+                parked_tail = prev;
+            }
+            op.next_parked = nullptr;
+            --parked_count;
+        }
+
+        // Move parked operations into SQ while there is space.
+        void unpark() noexcept {
+            while (parked_head) {
+                ::io_uring_sqe* sqe = ::io_uring_get_sqe(native());
+                if (!sqe) {
+                    return;
+                }
+                operation_base* op = std::exchange(parked_head, parked_head->next_parked);
+                op->next_parked = nullptr;
+                op->fill_sqe_ptr(op, sqe);
+                --parked_count;
+                if (!parked_head) {
+                    parked_tail = nullptr;
+                }
+            }
+        }
+
+        template<typename Pred>
+        std::error_code run_until(Pred&& pred,
+            std::chrono::steady_clock::time_point deadline) IOUXX_CALLBACK_NOEXCEPT {
+            using clock = std::chrono::steady_clock;
+            utility::defer reset{[this]() noexcept { run_stop_requested = false; }};
+            while (!run_stop_requested && !std::invoke(pred)) {
+                std::chrono::nanoseconds timeout{};
+                if (deadline != clock::time_point::max()) {
+                    timeout = deadline - clock::now();
+                    if (timeout.count() <= 0) {
+                        break;
+                    }
+                }
+                if (auto res = run_once(1, timeout); !res) {
+                    return res.error();
+                }
+            }
+            return std::error_code();
+        }
+
+        // Buffer rings are kept in a two-level table indexed by bgid,
+        // pages are allocated on first registration within their range.
+        static constexpr std::size_t buffer_ring_page_size = 256;
+        using buffer_ring_page = std::array<buffer_ring, buffer_ring_page_size>;
+
+        void rebind_parked() noexcept {
+            for (operation_base* op = parked_head; op; op = op->next_parked) {
+                op->ring_ptr = this;
+            }
+        }
+
+        void rebind_buffer_rings() noexcept {
+            for (auto& page : buffer_ring_pages) {
+                if (page) {
+                    for (buffer_ring& br : *page) {
+                        if (br.valid()) {
+                            br.rebind(native());
+                        }
+                    }
+                }
+            }
+        }
+
+        buffer_ring* lookup_buffer_ring(std::uint16_t bgid) noexcept {
+            auto& page = buffer_ring_pages[bgid / buffer_ring_page_size];
+            if (!page) {
+                return nullptr;
+            }
+            return &(*page)[bgid % buffer_ring_page_size];
+        }
+
         static ::io_uring invalid_ring() noexcept {
             return { .ring_fd = -1, .enter_ring_fd = -1 };
         }
@@ -1296,12 +2272,21 @@ namespace iouxx {
                 raw_ring = invalid_ring();
                 return utility::make_system_error_code(-ev);
             }
+            deferred_submission = opt.deferred;
             if (::io_uring_probe* raw = ::io_uring_get_probe_ring(&raw_ring)) {
                 probe.reset(raw);
+                for (std::size_t op = 0; op < supported_opcodes.size(); ++op) {
+                    supported_opcodes[op] = ::io_uring_opcode_supported(raw, static_cast<int>(op));
+                }
             } else {
                 exit();
                 return std::make_error_code(std::errc::not_enough_memory);
             }
+            // Already registered if the ring has no real fd
+            if (opt.register_fd && !(params.flags & IORING_SETUP_REGISTERED_FD_ONLY)) {
+                // Not fatal, ring works with plain fd as well
+                [[maybe_unused]] std::error_code res = register_ring_fd();
+            }
             return std::error_code();
         }
 
@@ -1348,13 +2333,420 @@ namespace iouxx {
 
         ::io_uring raw_ring = invalid_ring(); // using ring_fd to detect if valid
         probe_handle probe = nullptr;
-        std::vector<buffer_ring> buffer_rings = std::vector<buffer_ring>(buffer_ring_size_max);
+        std::bitset<std::numeric_limits<std::uint8_t>::max() + 1> supported_opcodes;
+        bool deferred_submission = false;
+        bool dispatching = false;
+        bool run_stop_requested = false;
+        bool ring_fd_registered = false;
+        iouops::operation_base* parked_head = nullptr;
+        iouops::operation_base* parked_tail = nullptr;
+        std::size_t parked_count = 0;
+        details::ready_node* ready_head = nullptr;
+        details::ready_node* ready_tail = nullptr;
+        std::array<std::unique_ptr<buffer_ring_page>,
+            buffer_ring_size_max / buffer_ring_page_size> buffer_ring_pages = {};
+    };
+
+    // Lease of a buffer selected by kernel from a buffer group
+    // (IOSQE_BUFFER_SELECT). The buffer is given back to the group on
+    // destruction, so received data can be used in place without copy.
+    // With incremental consumption, a lease covers one chunk of the buffer.
+    // While partial(), kernel still owns the rest of the buffer, and the
+    // buffer is only given back by the lease of its last chunk, which must
+    // be destroyed after leases of the other chunks.
+    // Note: leases must be destroyed on the thread running the ring,
+    //  and before the buffer group is unregistered.
+    class provided_buffer
+    {
+    public:
+        provided_buffer() = default;
+
+        // Take the buffer selected for a completion, empty if no buffer
+        // is selected (e.g. EOF).
+        static provided_buffer from_cqe(ring::buffer_group group,
+            int ev, std::uint32_t cqe_flags) noexcept {
+            if (!group || ev < 0 || !(cqe_flags & IORING_CQE_F_BUFFER)) {
+                return provided_buffer();
+            }
+            const auto bid = static_cast<std::uint16_t>(cqe_flags >> IORING_CQE_BUFFER_SHIFT);
+            const auto len = static_cast<std::size_t>(ev);
+            if (group.br->incremental()) {
+                const bool more = cqe_flags & IORING_CQE_F_BUF_MORE;
+                return provided_buffer(group, bid, group.br->consume(bid, len, more), len, more);
+            }
+            return provided_buffer(group, bid, 0, len, false);
+        }
+
+        provided_buffer(const provided_buffer&) = delete;
+        provided_buffer& operator=(const provided_buffer&) = delete;
+
+        provided_buffer(provided_buffer&& other) noexcept :
+            group(std::exchange(other.group, ring::buffer_group())),
+            bid(other.bid), off(other.off), len(std::exchange(other.len, 0)),
+            more(other.more)
+        {}
+
+        provided_buffer& operator=(provided_buffer&& other) noexcept {
+            provided_buffer(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        void swap(provided_buffer& other) noexcept {
+            std::ranges::swap(group, other.group);
+            std::ranges::swap(bid, other.bid);
+            std::ranges::swap(off, other.off);
+            std::ranges::swap(len, other.len);
+            std::ranges::swap(more, other.more);
+        }
+
+        ~provided_buffer() {
+            reset();
+        }
+
+        explicit operator bool() const noexcept {
+            return static_cast<bool>(group);
+        }
+
+        // Received bytes.
+        std::span<std::byte> data() const noexcept {
+            if (!group) {
+                return {};
+            }
+            return group.buffer(bid).subspan(off, len);
+        }
+
+        std::size_t size() const noexcept {
+            return len;
+        }
+
+        std::uint16_t buffer_id() const noexcept {
+            return bid;
+        }
+
+        // Offset of data in the buffer, always 0 unless consumed incrementally.
+        std::size_t offset() const noexcept {
+            return off;
+        }
+
+        // Whether kernel still owns the rest of the buffer (IORING_CQE_F_BUF_MORE).
+        bool partial() const noexcept {
+            return more;
+        }
+
+        // Give the buffer back to its group now.
+        // No-op for partial chunks, kernel is still filling the buffer.
+        void reset() noexcept {
+            if (group) {
+                if (!more && group.br->valid()) {
+                    group.recycle(bid);
+                }
+                group = ring::buffer_group();
+                len = 0;
+            }
+        }
+
+        // Keep the buffer out of its group, returns its bid.
+        // It can be given back later by ring::buffer_group::recycle().
+        std::uint16_t release() noexcept {
+            group = ring::buffer_group();
+            len = 0;
+            return bid;
+        }
+
+    private:
+        friend provided_buffer_bundle;
+        provided_buffer(ring::buffer_group group, std::uint16_t bid,
+            std::size_t offset, std::size_t len, bool more) noexcept :
+            group(group), bid(bid), off(offset), len(len), more(more)
+        {
+            if (!more) {
+                // Buffer is out of kernel
+                this->group.br->take();
+            }
+        }
+
+        ring::buffer_group group;
+        std::uint16_t bid = 0;
+        std::size_t off = 0;
+        std::size_t len = 0;
+        bool more = false;
+    };
+
+    // Leases of consecutive buffers filled by one bundle completion
+    // (IORING_RECVSEND_BUNDLE), in order of received data.
+    // Note: only for groups not consumed incrementally.
+    class provided_buffer_bundle
+    {
+    public:
+        provided_buffer_bundle() = default;
+
+        // Take the buffers selected for a completion, starting from the bid
+        // in cqe_flags, kernel fills them from consecutive ring entries.
+        // Fails with not_enough_memory, and the buffers are given back.
+        static std::expected<provided_buffer_bundle, std::error_code> from_cqe(
+            ring::buffer_group group, int ev, std::uint32_t cqe_flags) noexcept {
+            provided_buffer_bundle bundle;
+            if (!group || ev < 0 || !(cqe_flags & IORING_CQE_F_BUFFER)) {
+                return bundle;
+            }
+            IOUXX_ASSERT(!group.br->incremental());
+            bool failed = false;
+            auto remaining = static_cast<std::size_t>(ev);
+            auto bid = static_cast<std::uint16_t>(cqe_flags >> IORING_CQE_BUFFER_SHIFT);
+            do {
+                const std::size_t len = std::min(remaining, group.buffer(bid).size());
+                remaining -= len;
+                // Follow the link before the buffer may be given back
+                const std::uint16_t following = group.br->next(bid);
+                provided_buffer lease(group, bid, 0, len, false);
+                bid = following;
+                // Keep walking on failure, so remaining buffers are given back
+                if (!failed) {
+                    try {
+                        bundle.leases.push_back(std::move(lease));
+                    } catch (...) {
+                        failed = true;
+                    }
+                }
+            } while (remaining != 0);
+            if (failed) {
+                return utility::fail(std::errc::not_enough_memory);
+            }
+            bundle.total = static_cast<std::size_t>(ev);
+            return bundle;
+        }
+
+        std::span<provided_buffer> buffers() noexcept {
+            return leases;
+        }
+
+        std::span<const provided_buffer> buffers() const noexcept {
+            return leases;
+        }
+
+        // Total received bytes.
+        std::size_t bytes() const noexcept {
+            return total;
+        }
+
+        std::size_t size() const noexcept {
+            return leases.size();
+        }
+
+        bool empty() const noexcept {
+            return leases.empty();
+        }
+
+        // Give all buffers back to their group now.
+        void reset() noexcept {
+            leases.clear();
+            total = 0;
+        }
+
+    private:
+        std::vector<provided_buffer> leases;
+        std::size_t total = 0;
     };
 
 } // namespace iouxx
 
 namespace iouxx::details {
 
+    // Free indices of a registered buffer table, see fixed_buffer_pool.
+    class fixed_buffer_slots
+    {
+    public:
+        std::error_code init(std::uint16_t count) noexcept {
+            try {
+                free = std::make_unique<std::uint16_t[]>(count);
+            } catch (...) {
+                return std::make_error_code(std::errc::not_enough_memory);
+            }
+            // Lower indices are handed out first
+            for (std::uint16_t i = 0; i < count; ++i) {
+                free[i] = count - 1 - i;
+            }
+            top = count;
+            capacity = count;
+            return std::error_code();
+        }
+
+        // Hand over to the leases still out, the last one given back
+        // invokes cleanup(owner), which must destroy these slots.
+        void orphan(void (*cleanup)(void*) noexcept, void* owner) noexcept {
+            IOUXX_ASSERT(top != capacity);
+            orphan_cleanup = cleanup;
+            orphan_owner = owner;
+        }
+
+        // -1 if all indices are in use.
+        int acquire() noexcept {
+            if (top == 0) {
+                return -1;
+            }
+            return free[--top];
+        }
+
+        void release(std::uint16_t index) noexcept {
+            free[top++] = index;
+            if (orphan_cleanup && top == capacity) {
+                orphan_cleanup(orphan_owner);
+            }
+        }
+
+        std::uint16_t available() const noexcept {
+            return top;
+        }
+
+        void reset() noexcept {
+            free.reset();
+            top = 0;
+            capacity = 0;
+        }
+
+    private:
+        std::unique_ptr<std::uint16_t[]> free;
+        std::uint16_t top = 0;
+        std::uint16_t capacity = 0;
+        void (*orphan_cleanup)(void*) noexcept = nullptr;
+        void* orphan_owner = nullptr;
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Lease of a registered buffer of a fixed_buffer_pool, carrying both
+    // its memory and its index in the ring's buffer table. Pass it to
+    // fixed buffer operations (e.g. file_read_fixed_operation::buffer()),
+    // so the kernel skips pinning pages on each I/O.
+    // The buffer is given back to the pool on destruction.
+    // Note: keep the lease until operations using it complete. A lease
+    //  outliving its pool keeps its memory, but its index no longer refers
+    //  to a registered buffer.
+    class fixed_buffer
+    {
+    public:
+        fixed_buffer() = default;
+
+        fixed_buffer(const fixed_buffer&) = delete;
+        fixed_buffer& operator=(const fixed_buffer&) = delete;
+
+        fixed_buffer(fixed_buffer&& other) noexcept :
+            slots(std::exchange(other.slots, nullptr)),
+            buf(std::exchange(other.buf, {})),
+            idx(std::exchange(other.idx, -1))
+        {}
+
+        fixed_buffer& operator=(fixed_buffer&& other) noexcept {
+            fixed_buffer(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        void swap(fixed_buffer& other) noexcept {
+            std::ranges::swap(slots, other.slots);
+            std::ranges::swap(buf, other.buf);
+            std::ranges::swap(idx, other.idx);
+        }
+
+        ~fixed_buffer() {
+            reset();
+        }
+
+        explicit operator bool() const noexcept {
+            return slots != nullptr;
+        }
+
+        std::span<std::byte> data() const noexcept {
+            return buf;
+        }
+
+        std::size_t size() const noexcept {
+            return buf.size();
+        }
+
+        // Index in the buffer table, -1 if empty.
+        int index() const noexcept {
+            return idx;
+        }
+
+        // Give the buffer back to its pool now.
+        void reset() noexcept {
+            if (slots) {
+                slots->release(static_cast<std::uint16_t>(idx));
+                slots = nullptr;
+                buf = {};
+                idx = -1;
+            }
+        }
+
+    private:
+        friend fixed_buffer_pool;
+        fixed_buffer(details::fixed_buffer_slots& slots,
+            std::span<std::byte> buf, std::uint16_t index) noexcept :
+            slots(&slots), buf(buf), idx(index)
+        {}
+
+        details::fixed_buffer_slots* slots = nullptr;
+        std::span<std::byte> buf;
+        int idx = -1;
+    };
+
+} // namespace iouxx
+
+namespace iouxx::details {
+
+    // Base of operations selecting buffers from a buffer group.
+    class buffer_select_base
+    {
+    public:
+        template<typename Self>
+        Self& buffer_group(this Self& self, ring::buffer_group group) noexcept {
+            self.group = group;
+            return self;
+        }
+
+        // Transfer at most n bytes, 0 (default) for size of selected buffer.
+        // With incremental consumption, only the bytes transferred are
+        // consumed from the buffer.
+        // Note: multishot recv only accepts a limit since Linux 6.10,
+        //  older kernels fail it with invalid_argument (EINVAL).
+        template<typename Self>
+        Self& limit(this Self& self, std::uint32_t n) noexcept {
+            self.select_len = n;
+            return self;
+        }
+
+    protected:
+        void select(::io_uring_sqe* sqe) const noexcept {
+            sqe->flags |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group = group.id();
+        }
+
+        provided_buffer lease(int ev, std::uint32_t cqe_flags) const noexcept {
+            return provided_buffer::from_cqe(group, ev, cqe_flags);
+        }
+
+        std::expected<provided_buffer_bundle, std::error_code>
+        lease_bundle(int ev, std::uint32_t cqe_flags) const noexcept {
+            return provided_buffer_bundle::from_cqe(group, ev, cqe_flags);
+        }
+
+        // Buffers sent from the group as a queue, returns count of them.
+        std::uint32_t dequeue(int ev, std::uint32_t cqe_flags) const noexcept {
+            if (ev <= 0 || !(cqe_flags & IORING_CQE_F_BUFFER)) {
+                return 0;
+            }
+            return group.br->dequeue(
+                static_cast<std::uint16_t>(cqe_flags >> IORING_CQE_BUFFER_SHIFT),
+                static_cast<std::size_t>(ev));
+        }
+
+        ring::buffer_group group;
+        std::uint32_t select_len = 0;
+    };
+
     template<typename Operation>
     consteval bool test_operation_methods() noexcept {
         return operation_base::test_operation_methods_v<Operation>;
@@ -1369,6 +2761,37 @@ namespace iouxx::details {
         return static_cast<std::uint32_t>(r.native_handle());
     }
 
+    struct operation_access
+    {
+        // Unless stoppable, operation_canceled is delivered as a result
+        // instead of stopping the caller (see unhandled_stopped).
+        template<awaiter_operation Operation, typename CallerPromise, typename Result>
+        static void setup_awaiter(Operation& op, std::coroutine_handle<CallerPromise> handle,
+            std::expected<Result, std::error_code>& result, bool stoppable = true) noexcept {
+            op.setup_awaiter_callback(handle, result, stoppable);
+        }
+
+        template<awaiter_operation Operation, typename Result>
+        static void setup_join(Operation& op, join_state& join, std::size_t index,
+            std::expected<Result, std::error_code>& result) noexcept {
+            op.setup_join_callback(join, index, result);
+        }
+    };
+
+    inline bool defer_resume(ring& r, ready_node& node) noexcept {
+        if (!r.dispatching) {
+            return false;
+        }
+        node.next = nullptr;
+        if (r.ready_tail) {
+            r.ready_tail->next = &node;
+        } else {
+            r.ready_head = &node;
+        }
+        r.ready_tail = &node;
+        return true;
+    }
+
 } // namespace iouxx::details
 
 IOUXX_EXPORT
@@ -9,11 +9,20 @@
 #include "clock.hpp" // IWYU pragma: export
 
 #include "iouringxx.hpp" // IWYU pragma: export
+#include "ring_pool.hpp" // IWYU pragma: export
+#include "task.hpp" // IWYU pragma: export
+#include "execution.hpp" // IWYU pragma: export
+#include "timer_wheel.hpp" // IWYU pragma: export
+#include "buffer_pool.hpp" // IWYU pragma: export
 
 #include "iouops/noop.hpp" // IWYU pragma: export
+#include "iouops/link.hpp" // IWYU pragma: export
+#include "iouops/when.hpp" // IWYU pragma: export
+#include "iouops/deadline.hpp" // IWYU pragma: export
 #include "iouops/timeout.hpp" // IWYU pragma: export
 #include "iouops/cancel.hpp" // IWYU pragma: export
 #include "iouops/futex.hpp" // IWYU pragma: export
+#include "iouops/msgring.hpp" // IWYU pragma: export
 #include "iouops/network/socketio.hpp" // IWYU pragma: export
 #include "iouops/file/fileio.hpp" // IWYU pragma: export
 #include "iouops/file/directory.hpp" // IWYU pragma: export
@@ -28,6 +28,16 @@
 #define IOUXX_IORING_FEATURE_TESTS_ENABLED 0
 #endif // IOUXX_CONFIG_ENABLE_FEATURE_TESTS
 
+// IOUXX_CONFIG_DISABLE_FRAME_POOL
+// Define this macro will make coroutine frames of iouxx::task and
+// iouxx::detached_task allocated by global operator new directly,
+// instead of the thread local frame pool.
+#ifndef IOUXX_CONFIG_DISABLE_FRAME_POOL
+#define IOUXX_FRAME_POOL_ENABLED 1
+#else // IOUXX_CONFIG_DISABLE_FRAME_POOL
+#define IOUXX_FRAME_POOL_ENABLED 0
+#endif // IOUXX_CONFIG_DISABLE_FRAME_POOL
+
 // IOUXX_CONFIG_USE_CXX_MODULE
 // Define this macro to enable C++ module support.
 #ifdef IOUXX_CONFIG_USE_CXX_MODULE
@@ -0,0 +1,242 @@
+#pragma once
+#ifndef IOUXX_RING_POOL_H
+#define IOUXX_RING_POOL_H 1
+
+/*
+    * Thread-per-core runtime built on top of ring.
+*/
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cerrno>
+#include <functional>
+#include <latch>
+#include <new>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "macro_config.hpp"
+#include "cxxmodule_helper.hpp"
+#include "iouringxx.hpp"
+#include "iouops/file/fileio.hpp"
+#include "util/utility.hpp"
+#include "util/assertion.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // One worker thread pinned to each selected CPU, each worker owns a ring
+    // set up with single_issuer | defer_taskrun, and all worker rings are
+    // attached to io-wq backend of a ring owned by the pool.
+    // Workers run ring::run() until the pool is stopped.
+    // Note: a worker ring must only be used from its own thread,
+    //  use IORING_OP_MSG_RING (or other thread-safe means) to talk to it.
+    class ring_pool
+    {
+    public:
+        // Invoked in each worker thread with its ring and index,
+        // before entering event loop. May be invoked concurrently.
+        // An exception thrown from it fails start() (with the code of
+        // a std::system_error, operation_canceled otherwise).
+        using init_function = std::function<void(ring&, std::size_t)>;
+
+        ring_pool() = default;
+
+        explicit ring_pool(std::span<const std::uint32_t> cpus, std::size_t queue_depth,
+            init_function init, const ring_option& opt = ring_option()) {
+            std::error_code ec = start(cpus, queue_depth, std::move(init), opt);
+            if (ec) {
+                throw std::system_error(ec, "Failed to start ring pool");
+            }
+        }
+
+        ring_pool(const ring_pool&) = delete;
+        ring_pool& operator=(const ring_pool&) = delete;
+        ring_pool(ring_pool&&) = delete;
+        ring_pool& operator=(ring_pool&&) = delete;
+
+        ~ring_pool() { stop(); }
+
+        // Start one worker per cpu in cpus. Returns after every worker
+        // has set up its ring and run init, or fails if any of them fails.
+        // opt is the base option of worker rings.
+        std::error_code start(std::span<const std::uint32_t> cpus, std::size_t queue_depth,
+            init_function init, const ring_option& opt = ring_option()) noexcept {
+            IOUXX_ASSERT(!running());
+            if (cpus.empty()) {
+                return std::make_error_code(std::errc::invalid_argument);
+            }
+            if (std::error_code ec = backend.reinit(1)) {
+                return ec;
+            }
+            // Outlives the workers, which are joined by stop() on failure
+            std::latch ready(static_cast<std::ptrdiff_t>(cpus.size()));
+            try {
+                worker_init = std::move(init);
+                worker_option = opt;
+                worker_option
+                    .flags(ring_option::flag::single_issuer | ring_option::flag::defer_taskrun)
+                    .setup_attach(backend);
+                workers = std::vector<worker>(cpus.size());
+                for (std::size_t i = 0; i < cpus.size(); ++i) {
+                    worker& w = workers[i];
+                    w.cpu = cpus[i];
+                    w.event_fd = ::eventfd(0, EFD_CLOEXEC);
+                    if (w.event_fd < 0) {
+                        w.ec = utility::make_system_error_code(errno);
+                        ready.count_down(); // Not started
+                        continue;
+                    }
+                    try {
+                        w.thread = std::jthread(&ring_pool::worker_main,
+                            this, std::ref(w), i, queue_depth, std::ref(ready));
+                    } catch (const std::system_error& e) {
+                        w.ec = e.code();
+                        ready.count_down(); // Not started
+                    }
+                }
+                ready.wait();
+            } catch (...) {
+                stop();
+                return std::make_error_code(std::errc::not_enough_memory);
+            }
+            for (const worker& w : workers) {
+                if (w.ec) {
+                    std::error_code ec = w.ec;
+                    stop();
+                    return ec;
+                }
+            }
+            return std::error_code();
+        }
+
+        // Stop all workers and wait for them to exit.
+        // Operations still in flight are cancelled with their rings.
+        void stop() noexcept {
+            for (worker& w : workers) {
+                if (w.event_fd >= 0) {
+                    std::uint64_t one = 1;
+                    [[maybe_unused]] auto n = ::write(w.event_fd, &one, sizeof(one));
+                }
+            }
+            for (worker& w : workers) {
+                if (w.thread.joinable()) {
+                    w.thread.join();
+                }
+                if (w.event_fd >= 0) {
+                    ::close(w.event_fd);
+                }
+            }
+            workers.clear();
+            worker_init = nullptr;
+            backend.exit();
+        }
+
+        bool running() const noexcept {
+            return !workers.empty();
+        }
+
+        std::size_t size() const noexcept {
+            return workers.size();
+        }
+
+        // Ring owned by the worker, valid until the pool is stopped.
+        ring& worker_ring(std::size_t index) noexcept {
+            IOUXX_ASSERT(index < workers.size());
+            IOUXX_ASSERT(workers[index].ring_ptr != nullptr);
+            return *workers[index].ring_ptr;
+        }
+
+        std::uint32_t worker_cpu(std::size_t index) const noexcept {
+            IOUXX_ASSERT(index < workers.size());
+            return workers[index].cpu;
+        }
+
+        // The ring whose io-wq backend is shared by all workers.
+        ring& backend_ring() noexcept {
+            return backend;
+        }
+
+    private:
+        struct worker {
+            std::uint32_t cpu = 0;
+            int event_fd = -1;
+            ring* ring_ptr = nullptr;
+            std::error_code ec;
+            std::jthread thread;
+        };
+
+        static std::error_code pin_current_thread(std::uint32_t cpu) noexcept {
+            ::cpu_set_t mask;
+            CPU_ZERO(&mask);
+            CPU_SET(cpu, &mask);
+            if (::sched_setaffinity(0, sizeof(mask), &mask) != 0) {
+                return utility::make_system_error_code(errno);
+            }
+            return std::error_code();
+        }
+
+        void worker_main(worker& w, std::size_t index, std::size_t queue_depth,
+            std::latch& ready) noexcept {
+            // Ring is created in the worker thread, which becomes its single issuer
+            ring r;
+            std::uint64_t counter = 0;
+            bool stopped = false;
+            fileops::file_read_operation wakeup(r,
+                [&r, &stopped](std::expected<std::ptrdiff_t, std::error_code>) noexcept {
+                    stopped = true;
+                    r.stop_run();
+                });
+            std::error_code ec = pin_current_thread(w.cpu);
+            if (!ec) {
+                ec = r.reinit(queue_depth, worker_option);
+            }
+            if (!ec) {
+                wakeup.file(fileops::file(w.event_fd))
+                    .buffer(std::as_writable_bytes(std::span(&counter, 1)));
+                ec = wakeup.submit();
+            }
+            if (!ec && worker_init) {
+                try {
+                    std::invoke(worker_init, r, index);
+                } catch (const std::system_error& e) {
+                    ec = e.code();
+                } catch (const std::bad_alloc&) {
+                    ec = std::make_error_code(std::errc::not_enough_memory);
+                } catch (...) {
+                    ec = std::make_error_code(std::errc::operation_canceled);
+                }
+            }
+            w.ec = ec;
+            w.ring_ptr = ec ? nullptr : &r;
+            ready.count_down();
+            if (ec) {
+                return;
+            }
+            // User callbacks may stop the loop as well
+            while (!stopped) {
+                if (r.run()) {
+                    break;
+                }
+            }
+        }
+
+        ring backend;
+        ring_option worker_option;
+        init_function worker_init;
+        std::vector<worker> workers;
+    };
+
+} // namespace iouxx
+
+#endif // IOUXX_RING_POOL_H
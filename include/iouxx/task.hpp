@@ -0,0 +1,532 @@
+#pragma once
+#ifndef IOUXX_TASK_H
+#define IOUXX_TASK_H 1
+
+/*
+    * Coroutine types to drive awaitable operations.
+*/
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <new>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "macro_config.hpp"
+#include "cxxmodule_helper.hpp"
+#include "util/assertion.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+namespace iouxx::details {
+
+    // Thread local free lists of coroutine frames, one per size class.
+    // Frames of up to max_pooled_size bytes are recycled, larger ones and
+    // frames beyond the per-class limit go to global operator new/delete.
+    // A frame may be freed on another thread, it then joins that cache.
+    class frame_cache
+    {
+    public:
+        static constexpr std::size_t granularity = 64;
+        static constexpr std::size_t class_count = 32;
+        static constexpr std::size_t max_pooled_size = granularity * class_count;
+        static constexpr std::size_t default_max_cached = 64;
+
+        frame_cache() = default;
+        frame_cache(const frame_cache&) = delete;
+        frame_cache& operator=(const frame_cache&) = delete;
+
+        ~frame_cache() {
+            release();
+            // Frames destroyed later during thread exit bypass the cache
+            alive = false;
+        }
+
+        // Cache of current thread, nullptr once it is destroyed on thread exit.
+        static frame_cache* local() noexcept {
+            if (!alive) {
+                return nullptr;
+            }
+            static thread_local frame_cache cache;
+            return &cache;
+        }
+
+        void* allocate(std::size_t size) {
+            if (size == 0 || size > max_pooled_size) {
+                return heap_allocate(size);
+            }
+            size_class& c = classes[class_index(size)];
+            if (free_block* block = c.head) {
+                c.head = block->next;
+                --c.count;
+                return block;
+            }
+            return heap_allocate(size);
+        }
+
+        void deallocate(void* p, std::size_t size) noexcept {
+            if (size == 0 || size > max_pooled_size) {
+                heap_deallocate(p, size);
+                return;
+            }
+            size_class& c = classes[class_index(size)];
+            if (c.count >= max_cached) {
+                heap_deallocate(p, size);
+                return;
+            }
+            c.head = ::new (p) free_block{ c.head };
+            ++c.count;
+        }
+
+        // Pooled sizes are rounded up to their class, whether cached or not.
+        static void* heap_allocate(std::size_t size) {
+            if (size == 0 || size > max_pooled_size) {
+                return ::operator new(size);
+            }
+            return ::operator new(class_size(size));
+        }
+
+        static void heap_deallocate(void* p, std::size_t size) noexcept {
+            if (size == 0 || size > max_pooled_size) {
+                ::operator delete(p, size);
+            } else {
+                ::operator delete(p, class_size(size));
+            }
+        }
+
+        // Free cached frames until each class holds at most limit of them.
+        void trim(std::size_t limit) noexcept {
+            for (std::size_t i = 0; i < class_count; ++i) {
+                size_class& c = classes[i];
+                while (c.count > limit) {
+                    free_block* block = c.head;
+                    c.head = block->next;
+                    --c.count;
+                    ::operator delete(block, (i + 1) * granularity);
+                }
+            }
+        }
+
+        void release() noexcept {
+            trim(0);
+        }
+
+        std::size_t cached() const noexcept {
+            std::size_t total = 0;
+            for (const size_class& c : classes) {
+                total += c.count;
+            }
+            return total;
+        }
+
+        std::size_t max_cached = default_max_cached;
+
+    private:
+        struct free_block {
+            free_block* next;
+        };
+
+        struct size_class {
+            free_block* head = nullptr;
+            std::size_t count = 0;
+        };
+
+        static constexpr std::size_t class_index(std::size_t size) noexcept {
+            return (size - 1) / granularity;
+        }
+
+        static constexpr std::size_t class_size(std::size_t size) noexcept {
+            return (class_index(size) + 1) * granularity;
+        }
+
+        std::array<size_class, class_count> classes = {};
+        // Trivially destructible, so still readable after the cache is gone
+        static inline thread_local bool alive = true;
+    };
+
+    // Base of promise types, routes frame allocation to frame_cache.
+    struct pooled_frame
+    {
+#if IOUXX_FRAME_POOL_ENABLED
+        static void* operator new(std::size_t size) {
+            if (frame_cache* cache = frame_cache::local()) {
+                return cache->allocate(size);
+            }
+            return frame_cache::heap_allocate(size);
+        }
+
+        static void operator delete(void* p, std::size_t size) noexcept {
+            if (frame_cache* cache = frame_cache::local()) {
+                cache->deallocate(p, size);
+            } else {
+                frame_cache::heap_deallocate(p, size);
+            }
+        }
+#endif // IOUXX_FRAME_POOL_ENABLED
+    };
+
+    struct task_storage_base
+    {
+        static constexpr std::size_t empty = 0;
+        static constexpr std::size_t value = 1;
+        static constexpr std::size_t exception = 2;
+        using empty_type = std::monostate;
+        using exception_type = std::exception_ptr;
+        template<typename DataType>
+        using storage_type = std::variant<empty_type, DataType, exception_type>;
+
+        void throw_if_exception(this auto&& self) {
+            IOUXX_ASSERT(self.storage.index() != empty);
+            if (exception_type* ex = std::get_if<exception>(&self.storage)) {
+                std::rethrow_exception(*ex);
+            }
+        }
+
+        void unhandled_exception(this auto&& self,
+            exception_type e = std::current_exception()) noexcept {
+            self.storage.template emplace<exception>(std::move(e));
+        }
+    };
+
+    template<typename ReturnType>
+    class task_storage : public task_storage_base
+    {
+    public:
+        using return_type = ReturnType;
+    private:
+        using base = task_storage_base;
+        friend base;
+        static constexpr bool return_reference = std::is_reference_v<return_type>;
+    public:
+        using data_type = std::conditional_t<return_reference,
+            std::add_pointer_t<return_type>, return_type>;
+        using storage_type = base::storage_type<data_type>;
+
+        void return_value(return_type rt) noexcept requires (return_reference) {
+            this->storage.template emplace<value>(std::addressof(rt));
+        }
+
+        template<typename U = return_type>
+            requires (!return_reference)
+                && std::convertible_to<U, return_type>
+                && std::constructible_from<return_type, U>
+        void return_value(U&& rt) noexcept(std::is_nothrow_constructible_v<return_type, U>) {
+            this->storage.template emplace<value>(std::forward<U>(rt));
+        }
+
+        return_type do_resume() {
+            throw_if_exception();
+            if constexpr (return_reference) {
+                return static_cast<return_type>(*std::get<value>(this->storage));
+            } else {
+                return std::move(std::get<value>(this->storage));
+            }
+        }
+
+    private:
+        storage_type storage;
+    };
+
+    template<typename Void>
+        requires (std::is_void_v<Void>)
+    class task_storage<Void> : public task_storage_base
+    {
+    private:
+        using base = task_storage_base;
+        friend base;
+    public:
+        using return_type = void;
+        using data_type = std::monostate;
+        using storage_type = base::storage_type<data_type>;
+
+        void return_void() noexcept {
+            this->storage.template emplace<value>();
+        }
+
+        void do_resume() {
+            throw_if_exception();
+        }
+
+    private:
+        storage_type storage;
+    };
+
+    template<typename TaskType>
+    class task_promise : public task_storage<typename TaskType::return_type>,
+        public pooled_frame
+    {
+    public:
+        using task_type = TaskType;
+        using handle_type = std::coroutine_handle<task_promise>;
+        using return_type = typename task_type::return_type;
+
+        // Transfer control to awaiting coroutine without growing the stack.
+        struct [[nodiscard]] final_awaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template<typename PromiseType>
+            std::coroutine_handle<> await_suspend(
+                std::coroutine_handle<PromiseType> current) noexcept {
+                return static_cast<task_promise&>(current.promise()).continuation;
+            }
+
+            void await_resume() const noexcept { std::unreachable(); }
+        };
+
+        task_type get_return_object() noexcept {
+            return task_type(handle_type::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        final_awaiter final_suspend() const noexcept { return {}; }
+
+        void set_continuation(std::coroutine_handle<> c) noexcept {
+            continuation = c;
+        }
+
+    private:
+        std::coroutine_handle<> continuation = std::noop_coroutine();
+    };
+
+    template<typename TaskType>
+    class [[nodiscard]] task_awaiter
+    {
+    public:
+        using task_type = TaskType;
+        using handle_type = typename task_type::handle_type;
+        using return_type = typename task_type::return_type;
+
+        task_awaiter(const task_awaiter&) = delete;
+        task_awaiter& operator=(const task_awaiter&) = delete;
+
+        ~task_awaiter() {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+        }
+
+        bool await_ready() const noexcept {
+            return !coroutine;
+        }
+
+        // Symmetric transfer into the task
+        template<typename PromiseType>
+        handle_type await_suspend(std::coroutine_handle<PromiseType> current) noexcept {
+            coroutine.promise().set_continuation(current);
+            return coroutine;
+        }
+
+        return_type await_resume() {
+            IOUXX_ASSERT(coroutine);
+            return coroutine.promise().do_resume();
+        }
+
+    private:
+        friend task_type;
+        explicit task_awaiter(handle_type handle) noexcept : coroutine(handle) {}
+
+        handle_type coroutine = nullptr;
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Coroutine frame pool of current thread, shared by all tasks
+    // (and thus all rings) running on the thread. No locking is involved.
+    // Disabled by IOUXX_CONFIG_DISABLE_FRAME_POOL.
+    struct frame_pool
+    {
+        // Frames larger than this are always allocated from the heap.
+        static constexpr std::size_t max_pooled_size =
+            details::frame_cache::max_pooled_size;
+
+        // Upper bound of cached frames per size class, 0 disables caching.
+        static void set_max_cached(std::size_t count) noexcept {
+            if (details::frame_cache* cache = details::frame_cache::local()) {
+                cache->max_cached = count;
+                cache->trim(count);
+            }
+        }
+
+        static std::size_t max_cached() noexcept {
+            details::frame_cache* cache = details::frame_cache::local();
+            return cache ? cache->max_cached : 0;
+        }
+
+        // Number of frames cached by current thread.
+        static std::size_t cached() noexcept {
+            details::frame_cache* cache = details::frame_cache::local();
+            return cache ? cache->cached() : 0;
+        }
+
+        // Return all cached frames of current thread to the heap.
+        static void release() noexcept {
+            if (details::frame_cache* cache = details::frame_cache::local()) {
+                cache->release();
+            }
+        }
+    };
+
+    // Lazily started coroutine, runs when awaited, and resumes the awaiting
+    // coroutine by symmetric transfer when it finishes.
+    template<typename ReturnType = void>
+    class [[nodiscard]] task
+    {
+    public:
+        using return_type = ReturnType;
+        using promise_type = details::task_promise<task>;
+        using handle_type = typename promise_type::handle_type;
+        using awaiter_type = details::task_awaiter<task>;
+
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
+
+        task(task&& other) noexcept :
+            coroutine(std::exchange(other.coroutine, nullptr))
+        {}
+
+        task& operator=(task&& other) noexcept {
+            task(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        ~task() {
+            if (coroutine) {
+                coroutine.destroy();
+            }
+        }
+
+        void swap(task& other) noexcept {
+            std::ranges::swap(coroutine, other.coroutine);
+        }
+
+        awaiter_type operator co_await() && noexcept {
+            return awaiter_type(std::exchange(coroutine, nullptr));
+        }
+
+    private:
+        friend promise_type;
+        task() = default;
+        explicit task(handle_type handle) noexcept : coroutine(handle) {}
+
+        handle_type coroutine = nullptr;
+    };
+
+    // Eagerly owned top level coroutine, destroyed by itself on completion.
+    // Usually started once, and then driven by ring event loop.
+    class [[nodiscard]] detached_task
+    {
+    private:
+        struct detached_task_promise : details::pooled_frame
+        {
+            using handle_type = std::coroutine_handle<detached_task_promise>;
+
+            detached_task get_return_object() noexcept {
+                return detached_task(handle_type::from_promise(*this));
+            }
+
+            void return_void() const noexcept {}
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+
+            // Coroutine is destroyed on final suspend
+            std::suspend_never final_suspend() const noexcept { return {}; }
+
+            // Propagate to whoever resumed the coroutine, e.g. ring event loop
+            void unhandled_exception() noexcept(false) {
+                throw unhandled_exit_exception(handle_type::from_promise(*this));
+            }
+        };
+
+        using handle_type = detached_task_promise::handle_type;
+
+        detached_task() = default;
+        explicit detached_task(handle_type handle) noexcept : handle(handle) {}
+
+    public:
+        using promise_type = detached_task_promise;
+
+        detached_task(const detached_task&) = delete;
+        detached_task& operator=(const detached_task&) = delete;
+
+        detached_task(detached_task&& other) noexcept :
+            handle(std::exchange(other.handle, nullptr))
+        {}
+
+        detached_task& operator=(detached_task&& other) noexcept {
+            detached_task(std::move(other)).swap(*this);
+            return *this;
+        }
+
+        ~detached_task() {
+            if (handle) {
+                handle.destroy();
+            }
+        }
+
+        void swap(detached_task& other) noexcept {
+            std::ranges::swap(handle, other.handle);
+        }
+
+        // Thrown when detached task exits with unhandled exception,
+        // nested exception is the one thrown by the task.
+        // Responsible for destroying the coroutine.
+        class unhandled_exit_exception : public std::exception, public std::nested_exception
+        {
+        public:
+            unhandled_exit_exception() = default;
+            unhandled_exit_exception(const unhandled_exit_exception&) = default;
+            unhandled_exit_exception(unhandled_exit_exception&&) = default;
+            unhandled_exit_exception& operator=(const unhandled_exit_exception&) = default;
+            unhandled_exit_exception& operator=(unhandled_exit_exception&&) = default;
+            ~unhandled_exit_exception() override = default;
+
+            const char* what() const noexcept override {
+                return "Detached task exits with unhandled exception.";
+            }
+
+        private:
+            friend detached_task_promise;
+
+            static void handle_destroyer(void* p) noexcept {
+                handle_type::from_address(p).destroy();
+            }
+
+            // Implicitly captures current exception by std::nested_exception
+            explicit unhandled_exit_exception(handle_type handle) :
+                handle_holder(handle.address(), &handle_destroyer)
+            {}
+
+            std::shared_ptr<void> handle_holder = nullptr;
+        };
+
+        // Run until first suspension point.
+        // After that, the coroutine owns itself.
+        void start() && {
+            IOUXX_ASSERT(handle);
+            std::exchange(handle, nullptr).resume();
+        }
+
+        [[nodiscard]]
+        std::coroutine_handle<> to_handle() && noexcept {
+            return std::exchange(handle, nullptr);
+        }
+
+    private:
+        handle_type handle = nullptr;
+    };
+
+} // namespace iouxx
+
+#endif // IOUXX_TASK_H
@@ -0,0 +1,454 @@
+#pragma once
+#ifndef IOUXX_TIMER_WHEEL_H
+#define IOUXX_TIMER_WHEEL_H 1
+
+/*
+    * Userspace hierarchical timing wheel driven by one kernel timeout.
+*/
+
+#ifndef IOUXX_USE_CXX_MODULE
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include "macro_config.hpp"
+#include "cxxmodule_helper.hpp"
+#include "iouringxx.hpp"
+#include "iouops/timeout.hpp"
+#include "util/utility.hpp"
+#include "util/assertion.hpp"
+
+#endif // IOUXX_USE_CXX_MODULE
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Forward declaration
+    class timer_wheel;
+
+} // namespace iouxx
+
+namespace iouxx::details {
+
+    // Node of circular doubly linked list, the list head is a sentinel.
+    struct wheel_link {
+        wheel_link* prev = nullptr;
+        wheel_link* next = nullptr;
+
+        void reset() noexcept {
+            prev = next = this;
+        }
+
+        bool empty() const noexcept {
+            return next == this;
+        }
+
+        void push_back(wheel_link& node) noexcept {
+            node.prev = prev;
+            node.next = this;
+            prev->next = &node;
+            prev = &node;
+        }
+
+        void unlink() noexcept {
+            prev->next = next;
+            next->prev = prev;
+            prev = next = nullptr;
+        }
+
+        // Move all nodes of other to the back of this list.
+        void splice(wheel_link& other) noexcept {
+            if (other.empty()) {
+                return;
+            }
+            other.next->prev = prev;
+            prev->next = other.next;
+            other.prev->next = this;
+            prev = other.prev;
+            other.reset();
+        }
+    };
+
+} // namespace iouxx::details
+
+IOUXX_EXPORT
+namespace iouxx {
+
+    // Base of timers managed by timer_wheel.
+    // Like operations, timers are pinned and owned by user,
+    // they must outlive their time on the wheel.
+    class wheel_timer_base
+    {
+    public:
+        wheel_timer_base(const wheel_timer_base&) = delete;
+        wheel_timer_base& operator=(const wheel_timer_base&) = delete;
+
+        bool armed() const noexcept {
+            return link.next != nullptr;
+        }
+
+    protected:
+        using fire_type = void (*)(wheel_timer_base*) IOUXX_CALLBACK_NOEXCEPT;
+
+        explicit wheel_timer_base(fire_type fire) noexcept : fire_ptr(fire) {}
+
+        ~wheel_timer_base() {
+            IOUXX_ASSERT(!armed());
+        }
+
+    private:
+        friend timer_wheel;
+        details::wheel_link link; // First member, see timer_wheel::from_link
+        std::uint64_t expires = 0;
+        fire_type fire_ptr = nullptr;
+    };
+
+    // Timer invoking callback with no argument when expired.
+    template<std::invocable<> Callback>
+    class wheel_timer final : public wheel_timer_base
+    {
+    public:
+        template<utility::not_tag F>
+        explicit wheel_timer(F&& f) noexcept(std::is_nothrow_constructible_v<Callback, F>) :
+            wheel_timer_base(&fire), callback(std::forward<F>(f))
+        {}
+
+        template<typename F, typename... Args>
+        explicit wheel_timer(std::in_place_type_t<F>, Args&&... args)
+            noexcept(std::is_nothrow_constructible_v<F, Args...>) :
+            wheel_timer_base(&fire), callback(std::forward<Args>(args)...)
+        {}
+
+    private:
+        static void fire(wheel_timer_base* base) IOUXX_CALLBACK_NOEXCEPT {
+            std::invoke_r<void>(static_cast<wheel_timer*>(base)->callback);
+        }
+
+        [[no_unique_address]] Callback callback;
+    };
+
+    template<utility::not_tag F>
+    wheel_timer(F) -> wheel_timer<std::decay_t<F>>;
+
+    template<typename F, typename... Args>
+    wheel_timer(std::in_place_type_t<F>, Args&&...) -> wheel_timer<F>;
+
+    // Hierarchical timing wheel (4 levels of 64 slots) in userspace.
+    // Arm, cancel and re-arm are O(1), expired timers fire in batches,
+    // one batch per tick. However many timers are armed, the kernel only
+    // sees one timeout, armed for the earliest occupied slot and moved
+    // earlier in place (timeout update) when a nearer timer is armed.
+    // Nothing wakes the ring while the wheel is empty.
+    // Deadlines are rounded up to ticks, beyond range of the wheel
+    // (64^4 ticks) they are cascaded again until due.
+    // Note: the wheel is pinned, and must not be destroyed while its kernel
+    //  timeout is in flight (see running() and clear()).
+    class timer_wheel
+    {
+    public:
+        using clock = std::chrono::steady_clock;
+
+        static constexpr std::size_t level_bits = 6;
+        static constexpr std::size_t slots_per_level = std::size_t(1) << level_bits;
+        static constexpr std::size_t levels = 4;
+
+        explicit timer_wheel(iouxx::ring& ring,
+            std::chrono::nanoseconds resolution = std::chrono::milliseconds(1)) noexcept :
+            resolution(resolution), start(clock::now()),
+            driver(ring, std::in_place_type<driver_callback>, this),
+            updater(ring, std::in_place_type<update_callback>, this)
+        {
+            IOUXX_ASSERT(resolution.count() > 0);
+            for (auto& level : wheel) {
+                for (auto& slot : level) {
+                    slot.reset();
+                }
+            }
+            batch.reset();
+            updater.target(driver.identifier());
+        }
+
+        timer_wheel(const timer_wheel&) = delete;
+        timer_wheel& operator=(const timer_wheel&) = delete;
+
+        ~timer_wheel() {
+            IOUXX_ASSERT(!running());
+        }
+
+        // Arm (or re-arm) timer to expire after timeout.
+        // Only fails if the kernel timeout cannot be started or moved.
+        std::error_code arm(wheel_timer_base& timer, std::chrono::nanoseconds timeout) noexcept {
+            if (timer.armed()) {
+                timer.link.unlink();
+                --count;
+            }
+            const clock::time_point now = clock::now();
+            if (count == 0) {
+                // Nothing advanced the wheel while idle, catch up first so
+                // that the timer is not placed relative to a stale tick
+                current = std::max(current, elapsed_ticks(now));
+            }
+            // Rounded up, never fires early
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                now - start) + std::max(timeout, std::chrono::nanoseconds(0));
+            const auto due = static_cast<std::uint64_t>(
+                (elapsed.count() + resolution.count() - 1) / resolution.count());
+            timer.expires = std::max(due, current + 1);
+            insert(timer);
+            ++count;
+            switch (state) {
+            case driver_state::idle:
+                return start_driver();
+            case driver_state::armed:
+                if (timer.expires < armed_tick) {
+                    return retarget(timer.expires);
+                }
+                return std::error_code();
+            default:
+                // Re-armed once the batch or the cancellation completes
+                return std::error_code();
+            }
+        }
+
+        std::error_code arm(wheel_timer_base& timer, clock::time_point deadline) noexcept {
+            return arm(timer, deadline - clock::now());
+        }
+
+        // No-op if timer is not armed.
+        // The kernel timeout is left armed, and goes idle when it expires.
+        void cancel(wheel_timer_base& timer) noexcept {
+            if (timer.armed()) {
+                timer.link.unlink();
+                --count;
+            }
+        }
+
+        // Disarm all timers without firing them, and cancel the kernel timeout.
+        // The wheel can be destroyed once running() turns false.
+        void clear() noexcept {
+            for (auto& level : wheel) {
+                for (auto& slot : level) {
+                    while (!slot.empty()) {
+                        slot.next->unlink();
+                    }
+                }
+            }
+            // Also the rest of a batch being fired
+            while (!batch.empty()) {
+                batch.next->unlink();
+            }
+            count = 0;
+            if (state == driver_state::armed) {
+                if (!owner_ring().cancel_async(driver.identifier())) {
+                    state = driver_state::stopping;
+                }
+            }
+        }
+
+        // Fire all timers due by now. Normally called by the kernel timeout,
+        // can also be called manually. Returns number of fired timers.
+        std::size_t advance() IOUXX_CALLBACK_NOEXCEPT {
+            const std::uint64_t target = elapsed_ticks(clock::now());
+            std::size_t fired = 0;
+            while (current < target) {
+                if (count == 0) {
+                    // Nothing to cascade or fire
+                    current = target;
+                    break;
+                }
+                // Skip ticks with nothing to cascade or fire
+                current = std::min(target, next_event());
+                cascade();
+                fired += expire(wheel[0][current & slot_mask]);
+            }
+            return fired;
+        }
+
+        // Number of armed timers.
+        std::size_t size() const noexcept {
+            return count;
+        }
+
+        std::chrono::nanoseconds tick() const noexcept {
+            return resolution;
+        }
+
+        // Whether the kernel timeout (or its update) is in flight.
+        bool running() const noexcept {
+            return state != driver_state::idle || updating;
+        }
+
+        iouxx::ring& owner_ring() const noexcept {
+            return driver.owner_ring();
+        }
+
+    private:
+        static constexpr std::uint64_t slot_mask = slots_per_level - 1;
+
+        enum class driver_state : std::uint8_t { idle, armed, firing, stopping };
+
+        struct driver_callback {
+            timer_wheel* wheel;
+            void operator()(std::expected<void, std::error_code>)
+                IOUXX_CALLBACK_NOEXCEPT {
+                wheel->on_expire();
+            }
+        };
+
+        struct update_callback {
+            timer_wheel* wheel;
+            void operator()(std::expected<void, std::error_code>)
+                IOUXX_CALLBACK_NOEXCEPT {
+                // Fails if the timeout already fired, which re-arms it anyway
+                wheel->on_update();
+            }
+        };
+
+        static wheel_timer_base& from_link(details::wheel_link* link) noexcept {
+            return *reinterpret_cast<wheel_timer_base*>(link);
+        }
+
+        std::uint64_t elapsed_ticks(clock::time_point now) const noexcept {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - start);
+            return static_cast<std::uint64_t>(elapsed.count() / resolution.count());
+        }
+
+        clock::time_point tick_deadline(std::uint64_t tick) const noexcept {
+            return start + std::chrono::duration_cast<clock::duration>(
+                resolution * static_cast<std::int64_t>(tick));
+        }
+
+        void insert(wheel_timer_base& timer) noexcept {
+            const std::uint64_t delta = timer.expires - current;
+            std::size_t level = 0;
+            while (level + 1 < levels && delta >= (std::uint64_t(1) << (level_bits * (level + 1)))) {
+                ++level;
+            }
+            std::uint64_t slot_tick = timer.expires;
+            if (delta >= (std::uint64_t(1) << (level_bits * levels))) {
+                // Out of range, parked in the farthest slot and cascaded again
+                slot_tick = current + (std::uint64_t(1) << (level_bits * levels)) - 1;
+            }
+            wheel[level][(slot_tick >> (level_bits * level)) & slot_mask].push_back(timer.link);
+        }
+
+        // Earliest tick after current reaching an occupied slot,
+        // either to fire it (level 0) or to cascade it. Requires count != 0.
+        std::uint64_t next_event() const noexcept {
+            std::uint64_t best = ~std::uint64_t(0);
+            for (std::size_t level = 0; level < levels; ++level) {
+                const std::size_t shift = level_bits * level;
+                std::uint64_t tick = ((current >> shift) + 1) << shift;
+                for (std::size_t i = 0; i < slots_per_level && tick < best; ++i) {
+                    if (!wheel[level][(tick >> shift) & slot_mask].empty()) {
+                        best = tick;
+                        break;
+                    }
+                    tick += std::uint64_t(1) << shift;
+                }
+            }
+            return best;
+        }
+
+        // Redistribute higher level slots reached by current tick.
+        void cascade() noexcept {
+            for (std::size_t level = 1; level < levels; ++level) {
+                if (((current >> (level_bits * (level - 1))) & slot_mask) != 0) {
+                    return;
+                }
+                details::wheel_link pending;
+                pending.reset();
+                pending.splice(wheel[level][(current >> (level_bits * level)) & slot_mask]);
+                while (!pending.empty()) {
+                    wheel_timer_base& timer = from_link(pending.next);
+                    timer.link.unlink();
+                    insert(timer);
+                }
+            }
+        }
+
+        std::size_t expire(details::wheel_link& slot) IOUXX_CALLBACK_NOEXCEPT {
+            // Callbacks may arm, cancel or clear any timer, including ones in batch
+            batch.splice(slot);
+            std::size_t fired = 0;
+            while (!batch.empty()) {
+                wheel_timer_base& timer = from_link(batch.next);
+                timer.link.unlink();
+                --count;
+                ++fired;
+                timer.fire_ptr(&timer);
+            }
+            return fired;
+        }
+
+        std::error_code start_driver() noexcept {
+            armed_tick = next_event();
+            driver.wait_until(tick_deadline(armed_tick));
+            if (std::error_code ec = driver.submit()) {
+                return ec;
+            }
+            state = driver_state::armed;
+            return std::error_code();
+        }
+
+        // Move the in-flight kernel timeout earlier.
+        // Updates only ever move it earlier, so a stale one landing on
+        // a re-armed timeout at worst wakes the wheel early.
+        std::error_code retarget(std::uint64_t tick) noexcept {
+            armed_tick = tick;
+            if (updating) {
+                // Sent again once the current update completes
+                return std::error_code();
+            }
+            updater.wait_until(tick_deadline(tick));
+            if (std::error_code ec = updater.submit()) {
+                return ec;
+            }
+            updating = true;
+            updated_tick = tick;
+            return std::error_code();
+        }
+
+        void on_update() IOUXX_CALLBACK_NOEXCEPT {
+            updating = false;
+            if (state == driver_state::armed && armed_tick < updated_tick) {
+                [[maybe_unused]] std::error_code ec = retarget(armed_tick);
+            }
+        }
+
+        void on_expire() IOUXX_CALLBACK_NOEXCEPT {
+            // Expired, cancelled or failed, pick up whatever is due anyway
+            state = driver_state::firing;
+            advance();
+            state = driver_state::idle;
+            if (count != 0) {
+                [[maybe_unused]] std::error_code ec = start_driver();
+            }
+        }
+
+        std::chrono::nanoseconds resolution;
+        clock::time_point start;
+        std::uint64_t current = 0;
+        std::uint64_t armed_tick = 0;
+        std::uint64_t updated_tick = 0;
+        std::size_t count = 0;
+        driver_state state = driver_state::idle;
+        bool updating = false;
+        std::array<std::array<details::wheel_link, slots_per_level>, levels> wheel;
+        details::wheel_link batch; // Timers being fired
+        timeout_operation<driver_callback> driver;
+        timeout_update_operation<update_callback> updater;
+    };
+
+} // namespace iouxx
+
+#endif // IOUXX_TIMER_WHEEL_H
@@ -5,328 +5,21 @@ import iouxx;
 
 #else // !IOUXX_CONFIG_USE_CXX_MODULE
 
-#include <concepts>
-#include <cstddef>
-#include <variant>
-#include <exception>
-#include <coroutine>
-#include <utility>
-#include <memory>
-
 #include <chrono>
+#include <cstddef>
+#include <cstdlib>
 #include <print>
+#include <stop_token>
+#include <system_error>
+#include <thread>
 
 #include "iouxx/iouringxx.hpp"
+#include "iouxx/task.hpp"
 #include "iouxx/iouops/noop.hpp"
 #include "iouxx/iouops/timeout.hpp"
 
 #endif // IOUXX_CONFIG_USE_CXX_MODULE
 
-#define TEST_ASSERT(...) do { \
-    if (!(__VA_ARGS__)) { \
-        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
-        __FILE__, __LINE__); \
-        std::exit(-(__COUNTER__ + 1)); \
-    } \
-} while(0)
-
-// Copy from mylib::task and mylib::detached_task
-
-namespace mylib {
-
-    namespace details {
-
-        struct symmetric_task_storage_base
-        {
-            static constexpr std::size_t empty = 0;
-            static constexpr std::size_t value = 1;
-            static constexpr std::size_t exception = 2;
-            using empty_type = std::monostate;
-            using exception_type = std::exception_ptr;
-            template<typename DataType>
-            using storage_type = std::variant<empty_type, DataType, exception_type>;
-
-            void throw_if_exception(this auto&& self) {
-                TEST_ASSERT(self.storage.index() != empty && "Task result is uninitialized.");
-                if (exception_type* ex = std::get_if<exception>(&self.storage)) {
-                    std::rethrow_exception(*ex);
-                }
-            }
-
-            void unhandled_exception(this auto&& self, exception_type e = std::current_exception()) noexcept {
-                self.storage.template emplace<exception>(std::move(e));
-            }
-        };
-
-    } // namespace mylib::details
-
-    template<typename ReturnType>
-    class symmetric_task_storage : public details::symmetric_task_storage_base
-    {
-    public:
-        using return_type = ReturnType;
-    private:
-        using base = details::symmetric_task_storage_base;
-        friend base;
-        static constexpr bool return_reference = std::is_reference_v<return_type>;
-    public:
-        using data_type = std::conditional_t<return_reference, std::add_pointer_t<return_type>, return_type>;
-        using storage_type = base::storage_type<data_type>;
-
-        void return_value(return_type rt) noexcept requires (return_reference) {
-            this->storage.template emplace<value>(std::addressof(rt));
-        }
-
-        template<typename U = return_type>
-            requires (not return_reference) && std::convertible_to<U, return_type> && std::constructible_from<return_type, U>
-        void return_value(U&& rt) noexcept(std::is_nothrow_constructible_v<return_type, U>) {
-            this->storage.template emplace<value>(std::forward<U>(rt));
-        }
-
-        return_type do_resume() {
-            throw_if_exception();
-            if constexpr (return_reference) {
-                return static_cast<return_type>(*std::get<value>(this->storage));
-            } else {
-                return std::move(std::get<value>(this->storage));
-            }
-        }
-
-    private:
-        storage_type storage;
-    };
-
-    template<typename Void>
-        requires (std::is_void_v<Void>)
-    class symmetric_task_storage<Void> : public details::symmetric_task_storage_base
-    {
-    private:
-        using base = details::symmetric_task_storage_base;
-        friend base;
-    public:
-        using return_type = void;
-        using data_type = std::monostate;
-        using storage_type = base::storage_type<data_type>;
-
-        void return_void() noexcept { this->storage.template emplace<value>(); }
-
-        void do_resume() { throw_if_exception(); }
-
-    private:
-        storage_type storage;
-    };
-
-} // namespace mylib
-
-namespace mylib {
-
-    class [[nodiscard]] detached_task
-    {
-    private:
-        struct detached_task_promise
-        {
-            using handle_type = std::coroutine_handle<detached_task_promise>;
-            detached_task get_return_object() noexcept { return detached_task(handle_type::from_promise(*this)); }
-            void return_void() const noexcept {}
-            std::suspend_always initial_suspend() const noexcept { return {}; }
-            std::suspend_never final_suspend() const noexcept { return {}; } // coroutine destroyed on final suspend
-
-            void unhandled_exception() noexcept(false) {
-                // propagate exception to caller, executor, or whatever
-                throw detached_task_unhandled_exit_exception(handle_type::from_promise(*this));
-            }
-        };
-
-        detached_task() = default;
-
-        using handle_type = detached_task_promise::handle_type;
-        explicit detached_task(handle_type handle) noexcept : handle(handle) {}
-
-    public:
-        using promise_type = detached_task_promise;
-
-        detached_task(const detached_task&) = delete;
-        detached_task& operator=(const detached_task&) = delete;
-
-        detached_task(detached_task&& other) noexcept
-            : handle(std::exchange(other.handle, nullptr))
-        {}
-
-        detached_task& operator=(detached_task&& other) noexcept {
-            detached_task().swap(other);
-            return *this;
-        }
-
-        ~detached_task() { if (this->handle) { handle.destroy(); } }
-
-        void swap(detached_task& other) noexcept {
-            if (this == std::addressof(other)) { return; }
-            std::ranges::swap(this->handle, other.handle);
-        }
-
-        // thrown when detached task exits with unhandled exception
-        // nested exception is the exception thrown by the detached task
-        // responsible for destroying the coroutine
-        class detached_task_unhandled_exit_exception : public std::exception, public std::nested_exception
-        {
-        public:
-            friend promise_type;
-
-            // satisfy standard exception requirements
-
-            detached_task_unhandled_exit_exception() = default;
-            detached_task_unhandled_exit_exception(const detached_task_unhandled_exit_exception&) = default;
-            detached_task_unhandled_exit_exception(detached_task_unhandled_exit_exception&&) = default;
-            detached_task_unhandled_exit_exception& operator=(const detached_task_unhandled_exit_exception&) = default;
-            detached_task_unhandled_exit_exception& operator=(detached_task_unhandled_exit_exception&&) = default;
-
-            ~detached_task_unhandled_exit_exception() override = default;
-
-            const char* what() const noexcept override { return message; }
-
-        private:
-            static constexpr auto message = "Detached task exits with unhandled exception.";
-
-            static void handle_destroyer(void* p) noexcept { handle_type::from_address(p).destroy(); }
-
-            explicit detached_task_unhandled_exit_exception(handle_type handle)
-                // implicitly catch current exception via default init std::nested_exception
-                : handle_holder(handle.address(), &handle_destroyer)
-            {}
-
-            std::shared_ptr<void> handle_holder = nullptr;
-        };
-
-        // can only be called once
-        // once called, detached_task object is not responsible for destroying the coroutine
-        void start() && {
-            TEST_ASSERT(this->handle && "Task already start!");
-            std::exchange(this->handle, nullptr).resume();
-        }
-
-        [[nodiscard]]
-        handle_type to_handle() && noexcept { return std::exchange(this->handle, nullptr); }
-
-    private:
-        handle_type handle = nullptr;
-    };
-
-} // namespace mylib
-
-namespace mylib {
-
-    namespace details {
-    
-        template<typename TaskType>
-        class task_promise : public mylib::symmetric_task_storage<typename TaskType::return_type>
-        {
-        public:
-            using task_type = TaskType;
-            using handle_type = std::coroutine_handle<task_promise>;
-            using return_type = typename task_type::return_type;
-
-            // inherited from symmetric_task_storage:
-            // unhandled_exception
-            // return_value or return_void
-            // do_resume
-
-            struct [[nodiscard]] final_awaiter
-            {
-                bool await_ready() const noexcept { return false; }
-
-                template<typename PromiseType>
-                std::coroutine_handle<> await_suspend(std::coroutine_handle<PromiseType> current_coroutine) noexcept {
-                    return static_cast<task_promise&>(current_coroutine.promise()).continuation;
-                }
-
-                void await_resume() const noexcept { std::unreachable(); }
-            };
-
-            task_type get_return_object() { return task_type(handle_type::from_promise(*this)); }
-            std::suspend_always initial_suspend() noexcept { return {}; }
-            final_awaiter final_suspend() noexcept { return {}; }
-
-            void set_continuation(std::coroutine_handle<> c) noexcept { continuation = c; }
-
-        protected:
-            std::coroutine_handle<> continuation = std::noop_coroutine();
-        };
-
-        template<typename TaskType>
-        class [[nodiscard]] task_awaiter
-        {
-        public:
-            using task_type = TaskType;
-            using handle_type = typename task_type::handle_type;
-            using return_type = typename task_type::return_type;
-
-            ~task_awaiter() { if (this->coroutine) { this->coroutine.destroy(); } }
-
-            [[nodiscard]] bool await_ready() noexcept { return !this->coroutine; }
-
-            template<typename PromiseType>
-            handle_type await_suspend(std::coroutine_handle<PromiseType> current) noexcept {
-                this->coroutine.promise().set_continuation(current);
-                return this->coroutine;
-            }
-
-            return_type await_resume() { return this->coroutine.promise().do_resume(); }
-
-        private:
-            friend task_type;
-            explicit task_awaiter(handle_type handle) noexcept : coroutine(handle) {}
-
-            handle_type coroutine = nullptr;
-        };
-
-    } // namespace mylib::details
-
-    template<typename ReturnType>
-    class [[nodiscard]] task
-    {
-    public:
-        using return_type = ReturnType;
-        using promise_type = details::task_promise<task>;
-        using handle_type = typename promise_type::handle_type;
-        using task_awaiter = details::task_awaiter<task>;
-
-        task(const task&) = delete;
-        task& operator=(const task&) = delete;
-
-        task(task&& other) noexcept : coroutine(std::exchange(other.coroutine, nullptr)) {}
-        task& operator=(task&& other) noexcept {
-            task().swap(other);
-            return *this;
-        }
-
-        void swap(task& other) noexcept {
-            if (this == std::addressof(other)) return;
-            std::ranges::swap(this->coroutine, other.coroutine);
-        }
-
-        ~task() { if (this->coroutine) { this->coroutine.destroy(); } }
-
-        task_awaiter operator co_await() && noexcept {
-            return task_awaiter(std::exchange(this->coroutine, nullptr));
-        }
-
-        // Test only
-        return_type sync_await() && {
-            task_awaiter awaiter = std::move(*this).operator co_await();
-            awaiter.await_suspend(std::noop_coroutine()).resume();
-            return awaiter.await_resume();
-        }
-
-    private:
-        friend promise_type;
-        task() = default;
-        explicit task(handle_type handle) noexcept : coroutine(handle) {}
-
-        handle_type coroutine = nullptr;
-    };
-
-} // namespace mylib
-
 #define TEST_EXPECT(...) do { \
     if (!(__VA_ARGS__)) { \
         std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
@@ -341,7 +34,7 @@ struct noizy {
     ~noizy() { --count; std::println("noizy destructed"); }
 };
 
-mylib::task<int> wait_for(iouxx::ring& ring, std::chrono::nanoseconds duration) {
+iouxx::task<int> wait_for(iouxx::ring& ring, std::chrono::nanoseconds duration) {
     noizy _;
     auto op = ring.make_await<iouxx::timeout_operation>();
     op.wait_for(duration);
@@ -352,7 +45,7 @@ mylib::task<int> wait_for(iouxx::ring& ring, std::chrono::nanoseconds duration)
     co_return 42;
 }
 
-mylib::detached_task test(iouxx::ring& ring, int& result) {
+iouxx::detached_task test(iouxx::ring& ring, int& result) {
     noizy _;
     auto op = ring.make_await<iouxx::noop_operation>();
     std::println("Awaiting noop operation...");
@@ -364,6 +57,111 @@ mylib::detached_task test(iouxx::ring& ring, int& result) {
     std::println("wait_for completed.");
 }
 
+iouxx::task<int> nested(iouxx::ring& ring, int depth) {
+    if (depth == 0) {
+        auto op = ring.make_await<iouxx::noop_operation>();
+        auto res = co_await op;
+        TEST_EXPECT(res.has_value());
+        co_return 0;
+    }
+    co_return co_await nested(ring, depth - 1) + 1;
+}
+
+iouxx::detached_task worker(iouxx::ring& ring, int id, int& done, int* order, int& seq) {
+    for (int i = 0; i < 3; ++i) {
+        auto op = ring.make_await<iouxx::noop_operation>();
+        auto res = co_await op;
+        TEST_EXPECT(res.has_value());
+        // Resumed from ready queue, in completion order
+        order[seq++] = id;
+    }
+    TEST_EXPECT(co_await nested(ring, 1000) == 1000);
+    ++done;
+}
+
+void test_ready_queue() {
+    iouxx::ring ring(8);
+    int done = 0;
+    int order[6] = {};
+    int seq = 0;
+    worker(ring, 0, done, order, seq).start();
+    worker(ring, 1, done, order, seq).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done == 2; }));
+    for (int i = 0; i < 6; ++i) {
+        TEST_EXPECT(order[i] == i % 2);
+    }
+    std::println("Ready queue completed");
+}
+
+void test_frame_pool() {
+    iouxx::ring ring(8);
+    int done = 0;
+    int order[6] = {};
+    int seq = 0;
+    iouxx::frame_pool::release();
+    TEST_EXPECT(iouxx::frame_pool::cached() == 0);
+    // Frames of finished tasks are kept for reuse
+    worker(ring, 0, done, order, seq).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done == 1; }));
+    const std::size_t cached = iouxx::frame_pool::cached();
+    TEST_EXPECT(cached > 0);
+    // Same frame sizes, reused rather than growing the pool
+    seq = 0;
+    worker(ring, 1, done, order, seq).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done == 2; }));
+    TEST_EXPECT(iouxx::frame_pool::cached() == cached);
+    // Bounded per size class
+    iouxx::frame_pool::set_max_cached(0);
+    TEST_EXPECT(iouxx::frame_pool::cached() == 0);
+    seq = 0;
+    worker(ring, 0, done, order, seq).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done == 3; }));
+    TEST_EXPECT(iouxx::frame_pool::cached() == 0);
+    iouxx::frame_pool::set_max_cached(64);
+    std::println("Frame pool completed");
+}
+
+iouxx::detached_task cancellable(iouxx::ring& ring, std::stop_token token, bool& done) {
+    using namespace std::chrono_literals;
+    auto op = ring.make_await<iouxx::timeout_operation>();
+    op.wait_for(10s);
+    auto res = co_await op.with_stop_token(std::move(token));
+    TEST_EXPECT(!res && res.error() == std::errc::operation_canceled);
+    done = true;
+}
+
+void test_stop_token() {
+    using namespace std::chrono_literals;
+    iouxx::ring ring(8);
+    // Stop requested on the ring thread
+    std::stop_source source;
+    bool done = false;
+    auto start = std::chrono::steady_clock::now();
+    cancellable(ring, source.get_token(), done).start();
+    iouxx::timeout_operation timer(ring, [&source](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        source.request_stop();
+    });
+    timer.wait_for(10ms);
+    TEST_EXPECT(!timer.submit());
+    TEST_EXPECT(!ring.run_until([&done] { return done; }));
+    // Stop requested from another thread
+    std::stop_source remote;
+    done = false;
+    cancellable(ring, remote.get_token(), done).start();
+    std::jthread requester([&remote] {
+        std::this_thread::sleep_for(10ms);
+        remote.request_stop();
+    });
+    TEST_EXPECT(!ring.run_until([&done] { return done; }));
+    // Already stopped, never submitted
+    done = false;
+    cancellable(ring, remote.get_token(), done).start();
+    TEST_EXPECT(done);
+    TEST_EXPECT(std::chrono::steady_clock::now() - start < 5s);
+    std::println("Stop token completed");
+}
+
 int main() {
     iouxx::ring ring(8);
     int result = 0;
@@ -385,4 +183,7 @@ int main() {
     }
     TEST_EXPECT(result == 42);
     TEST_EXPECT(noizy::count == 0);
+    test_ready_queue();
+    test_frame_pool();
+    test_stop_token();
 }
@@ -0,0 +1,95 @@
+#include <unistd.h>
+
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <print>
+#include <span>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/task.hpp"
+#include "iouxx/iouops/noop.hpp"
+#include "iouxx/iouops/deadline.hpp"
+#include "iouxx/iouops/file/fileio.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+using namespace std::literals;
+
+iouxx::detached_task expire(iouxx::ring& ring, int fd, bool& done) {
+    std::byte buffer[16];
+    auto read = ring.make_await<iouxx::fileops::file_read_operation>();
+    read.file(iouxx::fileops::file(fd))
+        .buffer(std::span(buffer));
+    auto start = std::chrono::steady_clock::now();
+    // Nothing is ever written to the pipe
+    auto res = co_await iouxx::with_deadline(read, 20ms);
+    TEST_EXPECT(!res);
+    TEST_EXPECT(res.error() == std::errc::operation_canceled);
+    TEST_EXPECT(std::chrono::steady_clock::now() - start >= 20ms);
+    done = true;
+}
+
+iouxx::detached_task in_time(iouxx::ring& ring, bool& done) {
+    auto noop = ring.make_await<iouxx::noop_operation>();
+    auto res = co_await iouxx::with_deadline(noop,
+        std::chrono::steady_clock::now() + 10s);
+    TEST_EXPECT(res.has_value());
+    done = true;
+}
+
+void test_deadline_expire() {
+    int fds[2];
+    TEST_EXPECT(::pipe(fds) == 0);
+    iouxx::ring ring(8);
+    bool done = false;
+    expire(ring, fds[0], done).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done; }));
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::println("deadline expired");
+}
+
+void test_deadline_in_time() {
+    iouxx::ring ring(8, iouxx::ring_option().deferred_submit());
+    bool done = false;
+    in_time(ring, done).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done; }));
+    std::println("operation completed before deadline");
+}
+
+void test_deadline_callback() {
+    iouxx::ring ring(8);
+    bool called = false;
+    iouxx::noop_operation noop(ring, [&called](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        called = true;
+    });
+    auto deadline = iouxx::with_deadline(noop, 1s);
+    TEST_EXPECT(!deadline.submit());
+    TEST_EXPECT(!ring.run_until([&called] { return called; }));
+    std::println("deadline with callback completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_deadline_expire();
+    test_deadline_in_time();
+    test_deadline_callback();
+}
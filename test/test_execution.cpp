@@ -0,0 +1,115 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <version>
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <version>
+#include <chrono>
+#include <concepts>
+#include <cstdlib>
+#include <print>
+#include <stop_token>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/execution.hpp"
+#include "iouxx/iouops/noop.hpp"
+#include "iouxx/iouops/timeout.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+#ifdef __cpp_lib_senders
+
+namespace ex = std::execution;
+
+enum class outcome { pending, value, error, stopped };
+
+struct env {
+    std::stop_token token;
+    std::stop_token query(std::get_stop_token_t) const noexcept { return token; }
+};
+
+struct test_receiver {
+    using receiver_concept = ex::receiver_t;
+    outcome* out;
+    std::stop_token token = {};
+
+    void set_value(auto&&...) && noexcept { *out = outcome::value; }
+    void set_error(std::error_code) && noexcept { *out = outcome::error; }
+    void set_stopped() && noexcept { *out = outcome::stopped; }
+    env get_env() const noexcept { return { token }; }
+};
+
+void test_schedule() {
+    iouxx::ring ring(8);
+    iouxx::ring_scheduler sched(ring);
+    static_assert(ex::scheduler<iouxx::ring_scheduler>);
+    // Only values are guaranteed to complete on the ring
+    using sender_env = decltype(ex::get_env(sched.schedule()));
+    static_assert(std::invocable<ex::get_completion_scheduler_t<ex::set_value_t>,
+        const sender_env&>);
+    static_assert(!std::invocable<ex::get_completion_scheduler_t<ex::set_error_t>,
+        const sender_env&>);
+    static_assert(!std::invocable<ex::get_completion_scheduler_t<ex::set_stopped_t>,
+        const sender_env&>);
+    outcome out = outcome::pending;
+    int hops = 0;
+    auto sndr = ex::then(sched.schedule(), [&hops] noexcept { ++hops; });
+    auto state = ex::connect(std::move(sndr), test_receiver{ &out });
+    ex::start(state);
+    TEST_EXPECT(out == outcome::pending);
+    TEST_EXPECT(!ring.run_until([&out] { return out != outcome::pending; }));
+    TEST_EXPECT(out == outcome::value);
+    TEST_EXPECT(hops == 1);
+    std::println("Schedule completed");
+}
+
+void test_operation_sender() {
+    using namespace std::literals;
+    iouxx::ring ring(8);
+    outcome out = outcome::pending;
+    auto timer = iouxx::make_sender<iouxx::timeout_operation>(ring,
+        [](auto& op) noexcept { op.wait_for(10ms); });
+    auto state = ex::connect(std::move(timer), test_receiver{ &out });
+    ex::start(state);
+    TEST_EXPECT(!ring.run_until([&out] { return out != outcome::pending; }));
+    TEST_EXPECT(out == outcome::value);
+    // Stop request cancels in flight operation
+    std::stop_source source;
+    out = outcome::pending;
+    auto slow = iouxx::make_sender<iouxx::timeout_operation>(ring,
+        [](auto& op) noexcept { op.wait_for(10s); });
+    auto cancellable = ex::connect(std::move(slow), test_receiver{ &out, source.get_token() });
+    ex::start(cancellable);
+    source.request_stop();
+    TEST_EXPECT(!ring.run_until([&out] { return out != outcome::pending; }));
+    TEST_EXPECT(out == outcome::stopped);
+    std::println("Operation sender completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_schedule();
+    test_operation_sender();
+}
+
+#else // !__cpp_lib_senders
+
+int main() {
+    TEST_EXPECT(true);
+    std::println("std::execution is not available, skipped");
+}
+
+#endif // __cpp_lib_senders
@@ -1,4 +1,5 @@
 #include <stdio.h>
+#include <linux/fs.h>
 
 #ifdef IOUXX_CONFIG_USE_CXX_MODULE
 
@@ -7,6 +8,8 @@ import iouxx;
 
 #else // !IOUXX_CONFIG_USE_CXX_MODULE
 
+#include <cstddef>
+#include <cstdlib>
 #include <system_error>
 #include <string_view>
 #include <string>
@@ -149,7 +152,99 @@ void test_fileops_fixed() {
     }
 }
 
+void test_sqe_flags() {
+    using namespace iouxx;
+    ring ring(256);
+    auto open = ring.make_sync<fileops::file_open_operation>();
+    open.path("/tmp")
+        .options(fileops::open_flag::temporary_file
+            | fileops::open_flag::cloexec
+            | fileops::open_flag::readwrite)
+        .mode(fileops::open_mode::uread
+            | fileops::open_mode::uwrite);
+    auto opened = open.submit_and_wait();
+    if (!opened) {
+        LOG_ERR("Fail to open temporary file: {}", opened.error().message());
+        std::exit(1);
+    }
+    fileops::file fd = *opened;
+    std::string_view msg = "Hello, io_uring flags!";
+    {
+        // Forced to io-wq, with synchronous data write
+        auto write = ring.make_sync<fileops::file_write_operation>();
+        write.file(fd)
+            .buffer(std::as_bytes(std::span(msg)))
+            .offset(0)
+            .options(fileops::rw_flag::dsync | fileops::rw_flag::sync)
+            .async();
+        auto res = write.submit_and_wait();
+        if (!res || *res != static_cast<std::ptrdiff_t>(msg.size())) {
+            LOG_ERR("Fail to write with async/dsync");
+            std::exit(1);
+        }
+    }
+    {
+        // Drained behind everything submitted before
+        std::string buffer(msg.size(), '\0');
+        auto read = ring.make_sync<fileops::file_read_operation>();
+        read.file(fd)
+            .buffer(std::as_writable_bytes(std::span(buffer)))
+            .offset(0)
+            .drain();
+        auto res = read.submit_and_wait();
+        if (!res || buffer != msg) {
+            LOG_ERR("Fail to read with drain");
+            std::exit(1);
+        }
+    }
+    if (auto id = ring.register_personality()) {
+        auto write = ring.make_sync<fileops::file_write_operation>();
+        write.file(fd)
+            .buffer(std::as_bytes(std::span(msg)))
+            .offset(0)
+            .personality(*id);
+        auto res = write.submit_and_wait();
+        if (!res) {
+            LOG_ERR("Fail to write with personality: {}", res.error().message());
+            std::exit(1);
+        }
+        if (std::error_code ec = ring.unregister_personality(*id)) {
+            LOG_ERR("Fail to unregister personality: {}", ec.message());
+            std::exit(1);
+        }
+    } else {
+        LOG_INFO("Personality not supported: {}", id.error().message());
+    }
+#ifdef RWF_DONTCACHE
+    {
+        auto write = ring.make_sync<fileops::file_write_operation>();
+        write.file(fd)
+            .buffer(std::as_bytes(std::span(msg)))
+            .offset(0)
+            .options(fileops::rw_flag::uncached);
+        auto res = write.submit_and_wait();
+        if (res) {
+            LOG_INFO("Uncached write of {} bytes", *res);
+        } else if (res.error() == std::errc::operation_not_supported
+            || res.error() == std::errc::invalid_argument) {
+            // Before Linux 6.14, or not supported by the filesystem
+            LOG_INFO("Uncached write not supported: {}", res.error().message());
+        } else {
+            LOG_ERR("Fail to write uncached: {}", res.error().message());
+            std::exit(1);
+        }
+    }
+#endif // RWF_DONTCACHE
+    auto close = ring.make_sync<fileops::file_close_operation>();
+    close.file(fd);
+    if (!close.submit_and_wait()) {
+        LOG_ERR("Fail to close file");
+        std::exit(1);
+    }
+}
+
 int main() {
     test_fileops();
     test_fileops_fixed();
+    test_sqe_flags();
 }
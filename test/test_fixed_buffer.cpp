@@ -0,0 +1,173 @@
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <print>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/buffer_pool.hpp"
+#include "iouxx/iouops/file/fileio.hpp"
+#include "iouxx/iouops/network/socketio.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+using namespace std::literals;
+namespace network = iouxx::network;
+namespace fileops = iouxx::fileops;
+
+static std::string_view as_string(std::span<const std::byte> bytes) noexcept {
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+static void init_or_exit(iouxx::fixed_buffer_pool& pool, iouxx::ring& ring) {
+    if (std::error_code ec = pool.init(ring, 4, 4096, false)) {
+        // Registered memory is limited by RLIMIT_MEMLOCK
+        if (ec == std::errc::not_enough_memory
+            || ec == std::errc::operation_not_permitted) {
+            std::println("Buffer registration not permitted, treat as success");
+            std::exit(0);
+        }
+        TEST_EXPECT(false);
+    }
+}
+
+void test_lease() {
+    iouxx::ring ring(8);
+    iouxx::fixed_buffer_pool pool;
+    init_or_exit(pool, ring);
+    TEST_EXPECT(pool.size() == 4);
+    TEST_EXPECT(pool.available() == 4);
+
+    std::vector<iouxx::fixed_buffer> leases;
+    for (int i = 0; i < 4; ++i) {
+        auto lease = pool.acquire();
+        TEST_EXPECT(lease.has_value());
+        TEST_EXPECT(lease->index() == i);
+        TEST_EXPECT(lease->size() == 4096);
+        TEST_EXPECT(lease->data().data() == pool.buffer(i).data());
+        leases.push_back(std::move(*lease));
+    }
+    auto none = pool.acquire();
+    TEST_EXPECT(!none && none.error() == std::errc::no_buffer_space);
+    // Given back on destruction, and handed out again
+    leases.erase(leases.begin() + 2);
+    TEST_EXPECT(pool.available() == 1);
+    auto again = pool.acquire();
+    TEST_EXPECT(again.has_value() && again->index() == 2);
+    again->reset();
+    TEST_EXPECT(!*again);
+    leases.clear();
+    TEST_EXPECT(pool.available() == 4);
+    std::println("fixed buffer leases completed");
+}
+
+void test_file_io() {
+    iouxx::ring ring(8);
+    iouxx::fixed_buffer_pool pool;
+    init_or_exit(pool, ring);
+    const int fd = ::open("/tmp", O_TMPFILE | O_RDWR, 0600);
+    TEST_EXPECT(fd >= 0);
+
+    auto out = pool.acquire();
+    TEST_EXPECT(out.has_value());
+    std::memcpy(out->data().data(), "registered", 10);
+    auto write = ring.make_sync<fileops::file_write_fixed_operation>();
+    write.file(fileops::file(fd))
+        .buffer(*out, 10);
+    auto written = write.submit_and_wait();
+    TEST_EXPECT(written.has_value() && *written == 10);
+
+    auto in = pool.acquire();
+    TEST_EXPECT(in.has_value());
+    auto read = ring.make_sync<fileops::file_read_fixed_operation>();
+    read.file(fileops::file(fd))
+        .buffer(*in);
+    auto bytes = read.submit_and_wait();
+    TEST_EXPECT(bytes.has_value() && *bytes == 10);
+    TEST_EXPECT(as_string(in->data().first(10)) == "registered"sv);
+
+    ::close(fd);
+    std::println("fixed buffer file I/O completed");
+}
+
+void test_send() {
+    iouxx::ring ring(8);
+    iouxx::fixed_buffer_pool pool;
+    init_or_exit(pool, ring);
+    int fds[2];
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    auto lease = pool.acquire();
+    TEST_EXPECT(lease.has_value());
+    std::memcpy(lease->data().data(), "hello", 5);
+    auto send = ring.make_sync<network::socket_send_operation>();
+    send.socket(network::socket(fds[1], network::socket_config::domain::local,
+            network::socket_config::type::stream, network::socket_config::protocol{}))
+        .buffer(*lease, 5);
+    auto sent = send.submit_and_wait();
+    if (!sent && sent.error() == std::errc::invalid_argument) {
+        // Registered buffers for plain send since Linux 6.10
+        std::println("Send with registered buffer not supported, skipped");
+    } else {
+        TEST_EXPECT(sent.has_value() && *sent == 5);
+        char buf[8] = {};
+        TEST_EXPECT(::read(fds[0], buf, sizeof(buf)) == 5);
+        TEST_EXPECT(std::string_view(buf, 5) == "hello"sv);
+        std::println("fixed buffer send completed");
+    }
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+}
+
+void test_reset_with_leases() {
+    iouxx::ring ring(8);
+    iouxx::fixed_buffer_pool pool;
+    init_or_exit(pool, ring);
+    auto first = pool.acquire();
+    auto second = pool.acquire();
+    TEST_EXPECT(first.has_value() && second.has_value());
+    pool.reset();
+    TEST_EXPECT(!pool.valid());
+    TEST_EXPECT(pool.available() == 0);
+    // Memory of leases still out stays mapped
+    std::memset(first->data().data(), 'x', first->size());
+    first->reset();
+    std::memset(second->data().data(), 'y', second->size());
+    // Pool can be set up again meanwhile
+    init_or_exit(pool, ring);
+    TEST_EXPECT(pool.available() == 4);
+    second->reset();
+    TEST_EXPECT(pool.available() == 4);
+    std::println("fixed buffer reset with leases completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_lease();
+    test_file_io();
+    test_send();
+    test_reset_with_leases();
+}
@@ -0,0 +1,110 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <cstdlib>
+#include <cstddef>
+#include <expected>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/iouops/noop.hpp"
+#include "iouxx/iouops/link.hpp"
+#include "iouxx/iouops/file/fileio.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+void test_link_failure() {
+    iouxx::ring ring(64);
+    std::error_code first, second, third;
+    iouxx::noop_operation noop1(ring, [&](std::error_code ec) noexcept { first = ec; });
+    iouxx::noop_operation noop2(ring, [&](std::error_code ec) noexcept { second = ec; });
+    iouxx::noop_operation noop3(ring, [&](std::error_code ec) noexcept { third = ec; });
+    noop1.pseudo_result(std::make_error_code(std::errc::invalid_argument));
+    // Soft link: failure breaks the chain
+    int completed = 0;
+    TEST_EXPECT(!iouxx::link(noop1, noop2, noop3).submit());
+    while (completed < 3) {
+        auto res = ring.run_completions();
+        TEST_EXPECT(res);
+        completed += static_cast<int>(*res);
+    }
+    TEST_EXPECT(first == std::errc::invalid_argument);
+    TEST_EXPECT(second == std::errc::operation_canceled);
+    TEST_EXPECT(third == std::errc::operation_canceled);
+    // Hard link: failure does not break the chain
+    completed = 0;
+    iouxx::operation_chain chain(noop1, noop2, noop3);
+    chain.hardlink();
+    TEST_EXPECT(!chain.submit());
+    while (completed < 3) {
+        auto res = ring.run_completions();
+        TEST_EXPECT(res);
+        completed += static_cast<int>(*res);
+    }
+    TEST_EXPECT(first == std::errc::invalid_argument);
+    TEST_EXPECT(!second);
+    TEST_EXPECT(!third);
+    std::println("Link failure propagation completed");
+}
+
+void test_link_fileio() {
+    using namespace iouxx;
+    ring ring(64, ring_option().deferred_submit());
+    auto open = ring.make_sync<fileops::file_open_operation>();
+    open.path("/tmp")
+        .options(fileops::open_flag::temporary_file
+            | fileops::open_flag::cloexec
+            | fileops::open_flag::readwrite)
+        .mode(fileops::open_mode::uread
+            | fileops::open_mode::uwrite);
+    auto fd = open.submit_and_wait();
+    TEST_EXPECT(fd);
+    std::string_view msg = "Hello, linked io_uring!";
+    std::string buffer(msg.size(), '\0');
+    int completed = 0;
+    fileops::file_write_operation write(ring,
+        [&](std::expected<std::ptrdiff_t, std::error_code> res) noexcept {
+            TEST_EXPECT(res && *res == static_cast<std::ptrdiff_t>(msg.size()));
+            ++completed;
+        });
+    fileops::file_read_operation read(ring,
+        [&](std::expected<std::ptrdiff_t, std::error_code> res) noexcept {
+            TEST_EXPECT(res && *res == static_cast<std::ptrdiff_t>(msg.size()));
+            ++completed;
+        });
+    fileops::file_close_operation close(ring,
+        [&](std::error_code ec) noexcept {
+            TEST_EXPECT(!ec);
+            ++completed;
+        });
+    write.file(*fd).buffer(std::as_bytes(std::span(msg))).offset(0);
+    read.file(*fd).buffer(std::as_writable_bytes(std::span(buffer))).offset(0);
+    close.file(*fd);
+    TEST_EXPECT(!iouxx::link(write, read, close).submit());
+    // Whole chain is submitted and reaped by the loop
+    TEST_EXPECT(!ring.run_until([&completed] { return completed == 3; }));
+    TEST_EXPECT(buffer == msg);
+    std::println("Linked file operations completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_link_failure();
+    test_link_fileio();
+}
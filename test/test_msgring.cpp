@@ -0,0 +1,114 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <cstdint>
+#include <cstdlib>
+#include <expected>
+#include <print>
+#include <span>
+#include <string_view>
+#include <system_error>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/iouops/msgring.hpp"
+#include "iouxx/iouops/file/fileio.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+void test_msg_ring() {
+    iouxx::ring source(8);
+    iouxx::ring target(8);
+    int received = 0;
+    iouxx::ring_management_operation receiver(target,
+        [&](iouxx::management_info info) noexcept {
+            TEST_EXPECT(info.ring == &target);
+            TEST_EXPECT(info.ev == 42 + received);
+            if (received == 1) {
+                TEST_EXPECT(info.cqe_flags == 7);
+            }
+            ++received;
+        });
+    auto msg = source.make_sync<iouxx::msg_ring_operation>();
+    msg.target(target).receiver(receiver.identifier()).message(42);
+    TEST_EXPECT(msg.submit_and_wait());
+    // Fire-and-forget message with flags
+    iouxx::msg_ring_operation wakeup(source);
+    wakeup.target(target)
+        .receiver(receiver.identifier())
+        .message(43)
+        .message_flags(7);
+    TEST_EXPECT(!wakeup.submit());
+    while (received < 2) {
+        target.wait_for_result().value()();
+    }
+    std::println("Message ring completed");
+}
+
+void test_msg_ring_fd() {
+    using namespace iouxx;
+    ring source(8);
+    ring target(8);
+    if (source.register_direct_descriptor_table(4)
+        || target.register_direct_descriptor_table(4)) {
+        std::println("Direct descriptor table not supported, skipped");
+        return;
+    }
+    auto open = source.make_sync<fileops::fixed_file_open_operation>();
+    open.path("/tmp")
+        .options(fileops::open_flag::temporary_file | fileops::open_flag::readwrite)
+        .mode(fileops::open_mode::uread | fileops::open_mode::uwrite);
+    auto fd = open.submit_and_wait();
+    TEST_EXPECT(fd);
+    int target_slot = -1;
+    ring_management_operation receiver(target,
+        [&](management_info info) noexcept {
+            target_slot = info.ev;
+        });
+    auto send = source.make_sync<msg_ring_fd_operation>();
+    send.target(target).receiver(receiver.identifier()).source(*fd);
+    auto sent = send.submit_and_wait();
+    TEST_EXPECT(sent);
+    target.wait_for_result().value()();
+    TEST_EXPECT(target_slot == sent->index());
+    // Target ring can use the file now
+    auto write = target.make_sync<fileops::file_write_operation>();
+    std::string_view text = "moved";
+    write.file(*sent).buffer(std::as_bytes(std::span(text))).offset(0);
+    auto written = write.submit_and_wait();
+    TEST_EXPECT(written && *written == static_cast<std::ptrdiff_t>(text.size()));
+
+    // Explicit slot is reported as is
+    auto to_slot = source.make_sync<msg_ring_fd_operation>();
+    to_slot.target(target)
+        .receiver(receiver.identifier())
+        .source(*fd)
+        .destination(fileops::fixed_file(3))
+        .skip_target_cqe();
+    auto placed = to_slot.submit_and_wait();
+    TEST_EXPECT(placed && placed->index() == 3);
+    auto read = target.make_sync<fileops::file_read_operation>();
+    char buf[8] = {};
+    read.file(*placed).buffer(std::as_writable_bytes(std::span(buf))).offset(0);
+    auto bytes = read.submit_and_wait();
+    TEST_EXPECT(bytes && *bytes == static_cast<std::ptrdiff_t>(text.size()));
+    TEST_EXPECT(std::string_view(buf, text.size()) == text);
+    std::println("Message ring fd completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_msg_ring();
+    test_msg_ring_fd();
+}
@@ -96,7 +96,55 @@ void test_noop() {
     std::println("{}", sync_result4.error().message());
 }
 
+void test_skip_success() {
+    iouxx::ring ring(64);
+    if (!ring.test_feature(iouxx::ring::feature::cqe_skip)) {
+        std::println("CQE skip not supported, skipped");
+        return;
+    }
+    int called = 0;
+    auto callback = [&called](std::error_code ec) noexcept {
+        TEST_EXPECT(ec == std::errc::invalid_argument);
+        ++called;
+    };
+    iouxx::noop_operation skipped(ring, callback);
+    iouxx::noop_operation failed(ring, callback);
+    skipped.skip_success_cqe();
+    failed.skip_success_cqe().pseudo_result(std::errc::invalid_argument);
+    iouxx::noop_operation pure(ring);
+    pure.skip_success_cqe();
+    TEST_EXPECT(!skipped.submit());
+    TEST_EXPECT(!pure.submit());
+    TEST_EXPECT(!failed.submit());
+    // Only the failed one posts CQE
+    auto res = ring.run_once();
+    TEST_EXPECT(res && *res == 1);
+    TEST_EXPECT(called == 1);
+    res = ring.run_completions();
+    TEST_EXPECT(res && *res == 0);
+    std::println("Skip success CQE completed");
+}
+
+void test_drain_after_void() {
+    iouxx::ring ring(8);
+    // 'void' operations post CQE unless asked, so drain keeps working
+    iouxx::noop_operation pure(ring);
+    TEST_EXPECT(!pure.submit());
+    TEST_EXPECT(ring.run_once());
+    bool drained = false;
+    iouxx::noop_operation barrier(ring, [&drained](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        drained = true;
+    });
+    barrier.drain();
+    TEST_EXPECT(!barrier.submit());
+    TEST_EXPECT(!ring.run_until([&drained] { return drained; }));
+    std::println("Drain after void operation completed");
+}
+
 int main() {
     TEST_EXPECT(true);
     test_noop();
+    test_skip_success();
+    test_drain_after_void();
 }
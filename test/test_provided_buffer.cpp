@@ -0,0 +1,392 @@
+#include <liburing.h>
+#include <unistd.h>
+#include <sys/socket.h>
+
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <array>
+#include <cstddef>
+#include <cstdlib>
+#include <expected>
+#include <limits>
+#include <print>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/buffer_pool.hpp"
+#include "iouxx/iouops/network/socketio.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+using namespace std::literals;
+namespace network = iouxx::network;
+
+// Buffer rings are not available on older kernels
+static void exit_if_not_supported(const std::error_code& ec) noexcept {
+    if (ec == std::errc::invalid_argument
+        || ec == std::errc::function_not_supported
+        || ec == std::errc::operation_not_supported) {
+        std::println("Provided buffer ring not supported, treat as success");
+        std::exit(0);
+    }
+}
+
+static std::string_view as_string(std::span<const std::byte> bytes) noexcept {
+    return std::string_view(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+}
+
+static void send_raw(int fd, std::string_view msg) {
+    TEST_EXPECT(::write(fd, msg.data(), msg.size()) == static_cast<::ssize_t>(msg.size()));
+}
+
+void test_multishot_recv() {
+    iouxx::ring ring(8);
+    auto group = ring.register_buffer_group(4, 1);
+    if (!group) {
+        exit_if_not_supported(group.error());
+        TEST_EXPECT(false);
+    }
+    std::array<std::array<std::byte, 64>, 4> storage{};
+    for (std::uint16_t bid = 0; bid < storage.size(); ++bid) {
+        group->insert(std::span(storage[bid]), bid);
+    }
+    int fds[2];
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    std::vector<iouxx::provided_buffer> leases;
+    std::error_code error;
+    bool stopped = false;
+    iouxx::network::socket_multishot_recv_operation recv(ring,
+        [&](std::expected<network::multishot_recv_result, std::error_code> res) {
+            if (res) {
+                leases.push_back(std::move(res->buffer));
+                stopped = !res->more;
+            } else {
+                error = res.error();
+                stopped = true;
+            }
+        });
+    recv.socket(network::socket(fds[0], network::socket_config::domain::local,
+            network::socket_config::type::stream, network::socket_config::protocol{}))
+        .buffer_group(*group);
+    TEST_EXPECT(!recv.submit());
+
+    send_raw(fds[1], "hello"sv);
+    TEST_EXPECT(!ring.run_until([&] { return !leases.empty() || stopped; }));
+    TEST_EXPECT(leases.size() == 1);
+    TEST_EXPECT(as_string(leases[0].data()) == "hello"sv);
+    TEST_EXPECT(leases[0].buffer_id() < storage.size());
+    // Data is received in place, into the selected buffer
+    TEST_EXPECT(leases[0].data().data() == storage[leases[0].buffer_id()].data());
+    // Given back to the group
+    leases.clear();
+
+    // Hold all buffers, the next receive runs out of buffers
+    for (std::size_t i = 0; i < storage.size(); ++i) {
+        send_raw(fds[1], "data"sv);
+        TEST_EXPECT(!ring.run_until([&] { return leases.size() == i + 1 || stopped; }));
+        TEST_EXPECT(!stopped);
+    }
+    send_raw(fds[1], "more"sv);
+    TEST_EXPECT(!ring.run_until([&] { return stopped; }));
+    TEST_EXPECT(error == std::errc::no_buffer_space);
+    leases.clear();
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::println("multishot recv with provided buffers completed");
+}
+
+void test_buffer_pool() {
+    iouxx::ring ring(8);
+    iouxx::provided_buffer_pool pool;
+    if (std::error_code ec = pool.init(ring, 2, 8, 128)) {
+        exit_if_not_supported(ec);
+        TEST_EXPECT(false);
+    }
+    TEST_EXPECT(pool.size() == 8);
+    TEST_EXPECT(pool.buffer_size() == 128);
+    // Slab size overflowing size_t is rejected up front
+    iouxx::provided_buffer_pool huge;
+    TEST_EXPECT(huge.init(ring, 3, 8, std::numeric_limits<std::size_t>::max() / 4)
+        == std::errc::invalid_argument);
+    TEST_EXPECT(!huge.valid());
+    // Buffer ring entries are 32 bits long, incremental or not
+    TEST_EXPECT(huge.init(ring, 3, 8, std::size_t(1) << 32, false, false)
+        == std::errc::invalid_argument);
+    TEST_EXPECT(!huge.valid());
+    TEST_EXPECT(pool.stats().buffers == 8);
+    TEST_EXPECT(pool.stats().available() == 8);
+    pool.recycle_batch(4);
+    pool.low_watermark(2);
+    int fds[2];
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+
+    std::vector<iouxx::provided_buffer> leases;
+    bool stopped = false;
+    iouxx::network::socket_multishot_recv_operation recv(ring,
+        [&](std::expected<network::multishot_recv_result, std::error_code> res) {
+            if (res) {
+                leases.push_back(std::move(res->buffer));
+                stopped = !res->more;
+            } else {
+                stopped = true;
+            }
+        });
+    recv.socket(network::socket(fds[0], network::socket_config::domain::local,
+            network::socket_config::type::stream, network::socket_config::protocol{}))
+        .buffer_group(pool.group());
+    TEST_EXPECT(!recv.submit());
+
+    for (std::size_t i = 0; i < 6; ++i) {
+        send_raw(fds[1], "data"sv);
+        TEST_EXPECT(!ring.run_until([&] { return leases.size() == i + 1 || stopped; }));
+        TEST_EXPECT(!stopped);
+    }
+    auto stats = pool.stats();
+    TEST_EXPECT(stats.leased == 6);
+    TEST_EXPECT(stats.available() == 2);
+    TEST_EXPECT(stats.min_available == 2);
+    TEST_EXPECT(stats.low_watermark_hits == 1);
+
+    // Published at once while at low watermark
+    leases.resize(5);
+    TEST_EXPECT(pool.stats().pending == 0);
+    TEST_EXPECT(pool.stats().available() == 3);
+    // Otherwise published in batch
+    leases.resize(4);
+    stats = pool.stats();
+    TEST_EXPECT(stats.leased == 4);
+    TEST_EXPECT(stats.pending == 1);
+    TEST_EXPECT(stats.available() == 3);
+    leases.resize(1);
+    TEST_EXPECT(pool.stats().pending == 0);
+    TEST_EXPECT(pool.stats().available() == 7);
+    leases.clear();
+    TEST_EXPECT(pool.stats().pending == 1);
+    pool.commit();
+    TEST_EXPECT(pool.stats().available() == 8);
+
+    // Still receiving after recycle
+    send_raw(fds[1], "again"sv);
+    TEST_EXPECT(!ring.run_until([&] { return !leases.empty() || stopped; }));
+    TEST_EXPECT(!stopped);
+    TEST_EXPECT(as_string(leases[0].data()) == "again"sv);
+    leases.clear();
+
+    TEST_EXPECT(!ring.cancel_async(recv.identifier()));
+    TEST_EXPECT(!ring.run_until([&] { return stopped; }));
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::println("provided buffer pool completed");
+}
+
+void test_incremental() {
+    iouxx::ring ring(8);
+    auto group = ring.register_buffer_group(2, 3, true);
+    if (!group) {
+        // Since Linux 6.12
+        std::println("Incremental consumption not supported, skipped");
+        return;
+    }
+    TEST_EXPECT(group->incremental());
+    std::array<std::byte, 64> storage{};
+    group->insert(std::span(storage), 0);
+    int fds[2];
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    const network::socket sock(fds[0], network::socket_config::domain::local,
+        network::socket_config::type::stream, network::socket_config::protocol{});
+
+    auto recv_one = [&](std::string_view msg) {
+        send_raw(fds[1], msg);
+        auto recv = ring.make_sync<network::socket_recv_provided_operation>();
+        recv.socket(sock).buffer_group(*group);
+        auto res = recv.submit_and_wait();
+        TEST_EXPECT(res.has_value());
+        TEST_EXPECT(as_string(res->data()) == msg);
+        return std::move(*res);
+    };
+    // Chunks are appended to the same buffer
+    iouxx::provided_buffer first = recv_one("abc"sv);
+    TEST_EXPECT(first.buffer_id() == 0);
+    TEST_EXPECT(first.offset() == 0);
+    TEST_EXPECT(first.partial());
+    iouxx::provided_buffer second = recv_one("defg"sv);
+    TEST_EXPECT(second.buffer_id() == 0);
+    TEST_EXPECT(second.offset() == 3);
+    TEST_EXPECT(second.size() == 4);
+    TEST_EXPECT(second.partial());
+    TEST_EXPECT(second.data().data() == storage.data() + 3);
+    // Partial chunks are not leased out of kernel
+    TEST_EXPECT(group->stats().leased == 0);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::println("incremental consumption completed");
+}
+
+void test_bundle() {
+    iouxx::ring ring(8);
+    if (!ring.test_feature(iouxx::ring::feature::recvsend_bundle)) {
+        // Since Linux 6.10
+        std::println("Recv/send bundle not supported, skipped");
+        return;
+    }
+    auto recv_group = ring.register_buffer_group(4, 4);
+    auto send_group = ring.register_buffer_group(4, 5);
+    TEST_EXPECT(recv_group && send_group);
+    std::array<std::array<std::byte, 8>, 4> storage{};
+    for (std::uint16_t bid = 0; bid < storage.size(); ++bid) {
+        recv_group->insert(std::span(storage[bid]), bid);
+    }
+    int fds[2];
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    const network::socket sock(fds[0], network::socket_config::domain::local,
+        network::socket_config::type::stream, network::socket_config::protocol{});
+
+    // Received data spans consecutive buffers
+    send_raw(fds[1], "abcdefghijklmnopqrst"sv);
+    std::string received;
+    while (received.size() < 20) {
+        auto recv = ring.make_sync<network::socket_recv_bundle_operation>();
+        recv.socket(sock).buffer_group(*recv_group);
+        auto res = recv.submit_and_wait();
+        TEST_EXPECT(res.has_value() && !res->empty());
+        std::size_t bytes = 0;
+        for (const iouxx::provided_buffer& buf : res->buffers()) {
+            TEST_EXPECT(buf.data().data() == storage[buf.buffer_id()].data());
+            received += as_string(buf.data());
+            bytes += buf.size();
+        }
+        TEST_EXPECT(bytes == res->bytes());
+    }
+    TEST_EXPECT(received == "abcdefghijklmnopqrst"sv);
+    // All given back after the bundles are destroyed
+    TEST_EXPECT(recv_group->stats().leased == 0);
+
+    // Queued buffers are sent in order
+    std::string queued = "hello world";
+    send_group->insert(std::span(queued).first(6), 0);
+    send_group->insert(std::span(queued).subspan(6), 1);
+    auto send = ring.make_sync<network::socket_send_bundle_operation>();
+    send.socket(network::socket(fds[1], network::socket_config::domain::local,
+            network::socket_config::type::stream, network::socket_config::protocol{}))
+        .buffer_group(*send_group);
+    auto sent = send.submit_and_wait();
+    TEST_EXPECT(sent.has_value());
+    TEST_EXPECT(sent->bytes_sent == 11);
+    TEST_EXPECT(sent->first_bid == 0);
+    TEST_EXPECT(sent->buffers == 2);
+    TEST_EXPECT(send_group->stats().buffers == 0);
+    char out[16] = {};
+    TEST_EXPECT(::read(fds[0], out, sizeof(out)) == 11);
+    TEST_EXPECT(std::string_view(out, 11) == "hello world"sv);
+
+    ::close(fds[0]);
+    ::close(fds[1]);
+    std::println("recv/send bundle completed");
+}
+
+void test_shared_group() {
+    iouxx::ring ring(8);
+    if (!ring.test_feature(iouxx::ring::feature::recvsend_bundle)) {
+        std::println("Recv/send bundle not supported, skipped");
+        return;
+    }
+    auto group = ring.register_buffer_group(8, 6);
+    TEST_EXPECT(group);
+    std::array<std::array<std::byte, 4>, 8> storage{};
+    for (std::uint16_t bid = 0; bid < storage.size(); ++bid) {
+        group->insert(std::span(storage[bid]), bid);
+    }
+    int a[2], b[2];
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, a) == 0);
+    TEST_EXPECT(::socketpair(AF_UNIX, SOCK_STREAM, 0, b) == 0);
+
+    // Submitted first, completed last
+    std::vector<iouxx::provided_buffer_bundle> bundles;
+    std::string first, second;
+    auto on_recv = [&](std::string& out) {
+        return [&](std::expected<iouxx::provided_buffer_bundle, std::error_code> res) {
+            TEST_EXPECT(res.has_value());
+            for (const iouxx::provided_buffer& buf : res->buffers()) {
+                out += as_string(buf.data());
+            }
+            // Keep leases, so later selections are not the recycled buffers
+            bundles.push_back(std::move(*res));
+        };
+    };
+    iouxx::network::socket_recv_bundle_operation recv_a(ring, on_recv(first));
+    iouxx::network::socket_recv_bundle_operation recv_b(ring, on_recv(second));
+    recv_a.socket(network::socket(a[0], network::socket_config::domain::local,
+            network::socket_config::type::stream, network::socket_config::protocol{}))
+        .buffer_group(*group);
+    recv_b.socket(network::socket(b[0], network::socket_config::domain::local,
+            network::socket_config::type::stream, network::socket_config::protocol{}))
+        .buffer_group(*group);
+    TEST_EXPECT(!recv_a.submit());
+    TEST_EXPECT(!recv_b.submit());
+    send_raw(b[1], "bbbbbbbbbb"sv);
+    TEST_EXPECT(!ring.run_until([&] { return bundles.size() == 1; }));
+    send_raw(a[1], "aaaaaaa"sv);
+    TEST_EXPECT(!ring.run_until([&] { return bundles.size() == 2; }));
+    TEST_EXPECT(first == "aaaaaaa"sv);
+    TEST_EXPECT(second == "bbbbbbbbbb"sv);
+    bundles.clear();
+    TEST_EXPECT(group->stats().leased == 0);
+
+    // Completions reaped in other order than buffers were taken
+    auto other = ring.register_buffer_group(4, 7);
+    TEST_EXPECT(other);
+    for (std::uint16_t bid = 0; bid < 4; ++bid) {
+        other->insert(std::span(storage[bid]), bid);
+    }
+    auto later = iouxx::provided_buffer_bundle::from_cqe(*other, 8,
+        IORING_CQE_F_BUFFER | (2u << IORING_CQE_BUFFER_SHIFT));
+    TEST_EXPECT(later && later->size() == 2);
+    TEST_EXPECT(later->buffers()[0].buffer_id() == 2);
+    TEST_EXPECT(later->buffers()[1].buffer_id() == 3);
+    auto earlier = iouxx::provided_buffer_bundle::from_cqe(*other, 6,
+        IORING_CQE_F_BUFFER | (0u << IORING_CQE_BUFFER_SHIFT));
+    TEST_EXPECT(earlier && earlier->size() == 2);
+    TEST_EXPECT(earlier->buffers()[0].buffer_id() == 0);
+    TEST_EXPECT(earlier->buffers()[1].buffer_id() == 1);
+    TEST_EXPECT(earlier->buffers()[1].size() == 2);
+    // Not used for I/O, the kernel never selected these buffers
+    later->buffers()[0].release();
+    later->buffers()[1].release();
+    earlier->buffers()[0].release();
+    earlier->buffers()[1].release();
+
+    ::close(a[0]);
+    ::close(a[1]);
+    ::close(b[0]);
+    ::close(b[1]);
+    std::println("shared buffer group completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_multishot_recv();
+    test_buffer_pool();
+    test_incremental();
+    test_bundle();
+    test_shared_group();
+}
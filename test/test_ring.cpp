@@ -0,0 +1,366 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <system_error>
+#include <vector>
+#include <memory>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/task.hpp"
+#include "iouxx/iouops/noop.hpp"
+#include "iouxx/iouops/timeout.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+void test_deferred_submit() {
+    iouxx::ring ring(64, iouxx::ring_option().deferred_submit());
+    TEST_EXPECT(ring.deferred_submit());
+    int completed = 0;
+    auto callback = [&completed](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        ++completed;
+    };
+    using noop_type = iouxx::noop_operation<decltype(callback)>;
+    std::vector<std::unique_ptr<noop_type>> ops;
+    for (int i = 0; i < 16; ++i) {
+        ops.push_back(std::make_unique<noop_type>(ring, callback));
+        TEST_EXPECT(!ops.back()->submit());
+    }
+    TEST_EXPECT(ring.pending_submissions() == 16);
+    // Nothing is submitted yet
+    auto peek = ring.fetch_result();
+    TEST_EXPECT(!peek && peek.error() == std::errc::resource_unavailable_try_again);
+    TEST_EXPECT(!ring.flush());
+    TEST_EXPECT(ring.pending_submissions() == 0);
+    while (completed < 16) {
+        ring.wait_for_result().value()();
+    }
+    // wait_for_result submits pending SQEs by itself
+    auto sync_noop = ring.make_sync<iouxx::noop_operation>();
+    TEST_EXPECT(sync_noop.submit_and_wait());
+    // Back to immediate mode
+    TEST_EXPECT(!ring.set_deferred_submit(false));
+    noop_type last(ring, callback);
+    TEST_EXPECT(!last.submit());
+    TEST_EXPECT(ring.pending_submissions() == 0);
+    ring.wait_for_result().value()();
+    TEST_EXPECT(completed == 17);
+    std::println("Deferred submission completed");
+}
+
+void test_run_completions() {
+    iouxx::ring ring(64);
+    int completed = 0;
+    auto callback = [&completed](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        ++completed;
+    };
+    using noop_type = iouxx::noop_operation<decltype(callback)>;
+    constexpr int total = 40; // more than one batch
+    std::vector<std::unique_ptr<noop_type>> ops;
+    for (int i = 0; i < total; ++i) {
+        ops.push_back(std::make_unique<noop_type>(ring, callback));
+        TEST_EXPECT(!ops.back()->submit());
+    }
+    std::size_t reaped = 0;
+    // First pass is limited
+    auto res = ring.run_completions(3);
+    TEST_EXPECT(res && *res <= 3);
+    reaped += *res;
+    while (reaped < total) {
+        res = ring.run_completions();
+        TEST_EXPECT(res);
+        reaped += *res;
+    }
+    TEST_EXPECT(reaped == total);
+    TEST_EXPECT(completed == total);
+    // Nothing left
+    res = ring.run_completions();
+    TEST_EXPECT(res && *res == 0);
+    std::println("Batched completion completed");
+}
+
+void test_run_loop() {
+    using namespace std::literals;
+    iouxx::ring ring(64, iouxx::ring_option().deferred_submit());
+    // run_until
+    int completed = 0;
+    auto callback = [&completed](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        ++completed;
+    };
+    iouxx::noop_operation noop1(ring, callback);
+    iouxx::noop_operation noop2(ring, callback);
+    TEST_EXPECT(!noop1.submit());
+    TEST_EXPECT(!noop2.submit());
+    TEST_EXPECT(!ring.run_until([&completed] { return completed == 2; }));
+    TEST_EXPECT(completed == 2);
+    // run, stopped by callback
+    bool fired = false;
+    iouxx::timeout_operation timer(ring, [&](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        fired = true;
+        ring.stop_run();
+    });
+    timer.wait_for(10ms);
+    TEST_EXPECT(!timer.submit());
+    TEST_EXPECT(!ring.run());
+    TEST_EXPECT(fired);
+    TEST_EXPECT(!ring.stop_run_requested());
+    // run_for, nothing in flight
+    auto start = std::chrono::steady_clock::now();
+    TEST_EXPECT(!ring.run_for(20ms));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_EXPECT(elapsed >= 20ms && elapsed < 200ms);
+    // run_once with minimal completions
+    completed = 0;
+    TEST_EXPECT(!noop1.submit());
+    TEST_EXPECT(!noop2.submit());
+    auto res = ring.run_once(2);
+    TEST_EXPECT(res && *res == 2);
+    TEST_EXPECT(completed == 2);
+    std::println("Run loop completed");
+}
+
+void test_buffer_group_table() {
+    iouxx::ring ring(64);
+    TEST_EXPECT(!ring.find_buffer_group(7));
+    TEST_EXPECT(!ring.find_buffer_group(65535));
+    auto low = ring.register_buffer_group(8, 7);
+    TEST_EXPECT(low);
+    auto high = ring.register_buffer_group(8, 65535);
+    TEST_EXPECT(high);
+    TEST_EXPECT(ring.find_buffer_group(7));
+    TEST_EXPECT(ring.find_buffer_group(65535));
+    // Neighbour in the same page is still empty
+    TEST_EXPECT(!ring.find_buffer_group(8));
+    auto dup = ring.register_buffer_group(8, 7);
+    TEST_EXPECT(!dup && dup.error() == std::errc::file_exists);
+    ring.unregister_buffer_group(7);
+    TEST_EXPECT(!ring.find_buffer_group(7));
+    // Unregistering a group in an untouched page is a no-op
+    ring.unregister_buffer_group(1024);
+    TEST_EXPECT(ring.register_buffer_group(8, 7));
+    std::println("Buffer group table completed");
+}
+
+void test_swap() {
+    iouxx::ring ring(8);
+    iouxx::ring other;
+    TEST_EXPECT(ring.register_buffer_group(8, 3));
+    ring.swap(other);
+    TEST_EXPECT(!ring.valid());
+    TEST_EXPECT(other.valid());
+    // Buffer groups follow their io_uring instance
+    TEST_EXPECT(!ring.find_buffer_group(3));
+    TEST_EXPECT(other.find_buffer_group(3));
+    TEST_EXPECT(!ring.opcode_supported(iouxx::noop_operation<void>::opcode));
+    TEST_EXPECT(other.opcode_supported(iouxx::noop_operation<void>::opcode));
+    other.unregister_buffer_group(3);
+    TEST_EXPECT(other.register_buffer_group(8, 3));
+    auto noop = other.make_sync<iouxx::noop_operation>();
+    TEST_EXPECT(noop.submit_and_wait());
+    std::println("Swap completed");
+}
+
+void test_opcode_cache() {
+    iouxx::ring ring(8);
+    constexpr auto nop = iouxx::noop_operation<void>::opcode;
+    TEST_EXPECT(ring.opcode_supported(nop));
+    // Verified once, following submissions skip the test
+    iouxx::noop_operation noop(ring);
+    TEST_EXPECT(!noop.feature_test());
+    TEST_EXPECT(!noop.feature_test());
+    TEST_EXPECT(!ring.opcode_supported(255));
+    ring.exit();
+    TEST_EXPECT(!ring.opcode_supported(nop));
+    std::println("Opcode cache completed");
+}
+
+void test_registered_ring_fd() {
+    // Not registered by default
+    iouxx::ring plain(8);
+    TEST_EXPECT(!plain.is_ring_fd_registered());
+    // Registration failure is tolerated
+    iouxx::ring ring(8, iouxx::ring_option().register_ring_fd());
+    std::println("Ring fd registered: {}", ring.is_ring_fd_registered());
+    TEST_EXPECT(ring.native_handle() >= 0);
+    // Attaching still uses the real fd
+    iouxx::ring attached(8, iouxx::ring_option().setup_attach(ring));
+    TEST_EXPECT(attached.valid());
+    for (iouxx::ring* r : { &plain, &ring, &attached }) {
+        auto noop = r->make_sync<iouxx::noop_operation>();
+        TEST_EXPECT(noop.submit_and_wait());
+    }
+    // Registration follows the instance on swap
+    const bool registered = ring.is_ring_fd_registered();
+    plain.swap(ring);
+    TEST_EXPECT(plain.is_ring_fd_registered() == registered);
+    TEST_EXPECT(!ring.is_ring_fd_registered());
+    plain.swap(ring);
+    if (ring.is_ring_fd_registered()) {
+        TEST_EXPECT(!ring.unregister_ring_fd());
+        TEST_EXPECT(!ring.is_ring_fd_registered());
+        auto noop = ring.make_sync<iouxx::noop_operation>();
+        TEST_EXPECT(noop.submit_and_wait());
+    }
+    std::println("Registered ring fd completed");
+}
+
+void test_submit_burst() {
+    // SQ is much smaller than the burst
+    iouxx::ring ring(4, iouxx::ring_option()
+        .setup_cqsize(256)
+        .deferred_submit());
+    int completed = 0;
+    auto callback = [&completed](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        ++completed;
+    };
+    using noop_type = iouxx::noop_operation<decltype(callback)>;
+    constexpr int total = 128;
+    std::vector<std::unique_ptr<noop_type>> ops;
+    for (int i = 0; i < total; ++i) {
+        ops.push_back(std::make_unique<noop_type>(ring, callback));
+        // Full SQ is flushed or the operation is parked, never an error
+        TEST_EXPECT(!ops.back()->submit());
+    }
+    TEST_EXPECT(ring.pending_submissions() <= 4);
+    TEST_EXPECT(!ring.run_until([&completed] { return completed == total; }));
+    TEST_EXPECT(ring.parked_operations() == 0);
+    std::println("Submission burst completed");
+}
+
+// Submission fails until the ring is enabled, so a full SQ parks operations
+static iouxx::ring make_stuck_ring() {
+    return iouxx::ring(4, iouxx::ring_option()
+        .flags(iouxx::ring_option::flag::r_disabled)
+        .deferred_submit());
+}
+
+void test_parked_operations() {
+    iouxx::ring ring = make_stuck_ring();
+    int completed = 0;
+    int canceled = 0;
+    auto callback = [&](std::error_code ec) noexcept {
+        if (ec == std::errc::operation_canceled) {
+            ++canceled;
+        } else {
+            TEST_EXPECT(!ec);
+            ++completed;
+        }
+    };
+    using noop_type = iouxx::noop_operation<decltype(callback)>;
+    std::vector<std::unique_ptr<noop_type>> ops;
+    for (int i = 0; i < 8; ++i) {
+        ops.push_back(std::make_unique<noop_type>(ring, callback));
+        TEST_EXPECT(!ops.back()->submit());
+    }
+    TEST_EXPECT(ring.pending_submissions() == 4);
+    TEST_EXPECT(ring.parked_operations() == 4);
+    // Prepared SQE must not overtake parked operations
+    noop_type extra(ring, callback);
+    TEST_EXPECT(!extra.prepare());
+    TEST_EXPECT(ring.parked_operations() == 4);
+    // Parked target is completed at once, it never reaches the kernel
+    TEST_EXPECT(!ring.cancel_async(ops[6]->identifier()));
+    TEST_EXPECT(canceled == 1);
+    TEST_EXPECT(ring.parked_operations() == 3);
+
+    TEST_EXPECT(!ring.start_from_disabled());
+    TEST_EXPECT(!ring.run_until([&completed] { return completed == 7; }));
+    TEST_EXPECT(ring.parked_operations() == 0);
+    TEST_EXPECT(canceled == 1);
+    std::println("Parked operations completed");
+}
+
+iouxx::detached_task await_parked(iouxx::ring& ring, bool& done) {
+    auto noop = ring.make_await<iouxx::noop_operation>();
+    auto res = co_await noop;
+    TEST_EXPECT(!res && res.error() == std::errc::operation_canceled);
+    done = true;
+}
+
+void test_exit_parked() {
+    iouxx::ring ring = make_stuck_ring();
+    int canceled = 0;
+    auto callback = [&canceled](std::error_code ec) noexcept {
+        TEST_EXPECT(ec == std::errc::operation_canceled);
+        ++canceled;
+    };
+    using noop_type = iouxx::noop_operation<decltype(callback)>;
+    std::vector<std::unique_ptr<noop_type>> ops;
+    for (int i = 0; i < 6; ++i) {
+        ops.push_back(std::make_unique<noop_type>(ring, callback));
+        TEST_EXPECT(!ops.back()->submit());
+    }
+    bool done = false;
+    await_parked(ring, done).start();
+    TEST_EXPECT(ring.parked_operations() == 3);
+    // Parked operations are completed, awaiter included
+    ring.exit();
+    TEST_EXPECT(canceled == 2);
+    TEST_EXPECT(done);
+    std::println("Exit with parked operations completed");
+}
+
+void test_swap_parked() {
+    iouxx::ring ring = make_stuck_ring();
+    int completed = 0;
+    auto callback = [&completed](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        ++completed;
+    };
+    using noop_type = iouxx::noop_operation<decltype(callback)>;
+    std::vector<std::unique_ptr<noop_type>> ops;
+    for (int i = 0; i < 6; ++i) {
+        ops.push_back(std::make_unique<noop_type>(ring, callback));
+        TEST_EXPECT(!ops.back()->submit());
+    }
+    TEST_EXPECT(ring.parked_operations() == 2);
+    // Parked queue moves with the io_uring instance
+    iouxx::ring other;
+    ring.swap(other);
+    TEST_EXPECT(ring.parked_operations() == 0);
+    TEST_EXPECT(other.parked_operations() == 2);
+    TEST_EXPECT(other.deferred_submit() && !ring.deferred_submit());
+    for (auto& op : ops) {
+        TEST_EXPECT(&op->owner_ring() == (op.get() == ops[4].get()
+            || op.get() == ops[5].get() ? &other : &ring));
+    }
+    TEST_EXPECT(!other.start_from_disabled());
+    // SQEs already in SQ went with the instance too, all complete on other
+    TEST_EXPECT(!other.run_until([&completed] { return completed == 6; }));
+    TEST_EXPECT(other.parked_operations() == 0);
+    std::println("Swap with parked operations completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_deferred_submit();
+    test_run_completions();
+    test_run_loop();
+    test_buffer_group_table();
+    test_swap();
+    test_opcode_cache();
+    test_registered_ring_fd();
+    test_submit_burst();
+    test_parked_operations();
+    test_exit_parked();
+    test_swap_parked();
+}
@@ -0,0 +1,94 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <print>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/ring_pool.hpp"
+#include "iouxx/iouops/noop.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+void test_ring_pool() {
+    const unsigned ncpu = std::max(1u, std::min(std::thread::hardware_concurrency(), 4u));
+    std::vector<std::uint32_t> cpus;
+    for (std::uint32_t cpu = 0; cpu < ncpu; ++cpu) {
+        cpus.push_back(cpu);
+    }
+    std::atomic<std::size_t> initialized = 0;
+    iouxx::ring_pool pool;
+    std::error_code ec = pool.start(cpus, 64,
+        [&initialized](iouxx::ring& ring, std::size_t) {
+            // Worker ring is usable from its own thread
+            auto noop = ring.make_sync<iouxx::noop_operation>();
+            TEST_EXPECT(noop.submit_and_wait());
+            initialized.fetch_add(1);
+        });
+    if (ec == std::errc::invalid_argument) {
+        // DEFER_TASKRUN needs Linux 6.1
+        std::println("Ring pool not supported: {}", ec.message());
+        return;
+    }
+    TEST_EXPECT(!ec);
+    TEST_EXPECT(pool.running());
+    TEST_EXPECT(pool.size() == cpus.size());
+    for (std::size_t i = 0; i < pool.size(); ++i) {
+        TEST_EXPECT(pool.worker_cpu(i) == cpus[i]);
+        TEST_EXPECT(pool.worker_ring(i).test_flag(
+            iouxx::ring_option::flag::single_issuer));
+    }
+    while (initialized.load() != cpus.size()) {
+        std::this_thread::yield();
+    }
+    pool.stop();
+    TEST_EXPECT(!pool.running());
+    // Restartable
+    TEST_EXPECT(!pool.start(cpus, 16, nullptr));
+    pool.stop();
+    std::println("Ring pool completed");
+}
+
+void test_init_failure() {
+    const std::uint32_t cpus[] = { 0 };
+    iouxx::ring_pool pool;
+    std::error_code ec = pool.start(cpus, 16,
+        [](iouxx::ring&, std::size_t) {
+            throw std::system_error(std::make_error_code(std::errc::permission_denied));
+        });
+    if (ec == std::errc::invalid_argument) {
+        std::println("Ring pool not supported: {}", ec.message());
+        return;
+    }
+    // Reported by start(), and the worker is gone
+    TEST_EXPECT(ec == std::errc::permission_denied);
+    TEST_EXPECT(!pool.running());
+    ec = pool.start(cpus, 16, [](iouxx::ring&, std::size_t) { throw 42; });
+    TEST_EXPECT(ec == std::errc::operation_canceled);
+    TEST_EXPECT(!pool.running());
+    std::println("Ring pool init failure completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_ring_pool();
+    test_init_failure();
+}
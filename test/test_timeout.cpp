@@ -7,6 +7,7 @@ import iouxx;
 
 #include <chrono>
 #include <cstdlib>
+#include <system_error>
 #include <print>
 
 #include "iouxx/iouringxx.hpp"
@@ -93,9 +94,38 @@ void test_ring_stop() {
     std::println("Ring stopped");
 }
 
+void test_timeout_update() {
+    using namespace std::literals;
+    iouxx::ring ring(64);
+    bool fired = false;
+    iouxx::timeout_operation timer(ring, [&fired](std::error_code ec) noexcept {
+        TEST_EXPECT(!ec);
+        fired = true;
+    });
+    timer.wait_for(10s);
+    auto start = std::chrono::steady_clock::now();
+    TEST_EXPECT(!timer.submit());
+    // Shorten the deadline in place, no cancel and resubmit
+    auto update = ring.make_sync<iouxx::timeout_update_operation>();
+    update.target(timer.identifier()).wait_for(20ms);
+    TEST_EXPECT(update.submit_and_wait());
+    while (!fired) {
+        TEST_EXPECT(ring.run_once());
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_EXPECT(elapsed >= 20ms && elapsed < 5s);
+    // Target has gone
+    auto stale = ring.make_sync<iouxx::timeout_update_operation>();
+    stale.target(timer.identifier()).wait_for(20ms);
+    auto res = stale.submit_and_wait();
+    TEST_EXPECT(!res && res.error() == std::errc::no_such_file_or_directory);
+    std::println("Timeout update completed.");
+}
+
 int main() {
     TEST_EXPECT(true);
     test_timeout();
     test_multishot_timeout();
     test_ring_stop();
+    test_timeout_update();
 }
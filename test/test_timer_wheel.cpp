@@ -0,0 +1,173 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <print>
+#include <thread>
+#include <vector>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/timer_wheel.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+using namespace std::literals;
+
+void test_arm_cancel() {
+    iouxx::ring ring(16);
+    iouxx::timer_wheel wheel(ring);
+    int fired_a = 0, fired_b = 0, fired_c = 0;
+    iouxx::wheel_timer a([&] noexcept { ++fired_a; });
+    iouxx::wheel_timer b([&] noexcept { ++fired_b; });
+    iouxx::wheel_timer c([&] noexcept { ++fired_c; });
+    auto start = std::chrono::steady_clock::now();
+    TEST_EXPECT(!wheel.arm(a, 5ms));
+    TEST_EXPECT(!wheel.arm(b, 10ms));
+    TEST_EXPECT(!wheel.arm(c, 150ms)); // Lives in second level
+    TEST_EXPECT(wheel.size() == 3);
+    TEST_EXPECT(wheel.running());
+    wheel.cancel(b);
+    TEST_EXPECT(!b.armed());
+    // Re-arm pushes the deadline back
+    TEST_EXPECT(!wheel.arm(a, 20ms));
+    TEST_EXPECT(wheel.size() == 2);
+    TEST_EXPECT(!ring.run_until([&] { return fired_a == 1; }));
+    TEST_EXPECT(std::chrono::steady_clock::now() - start >= 20ms);
+    TEST_EXPECT(!ring.run_until([&] { return fired_c == 1; }));
+    TEST_EXPECT(std::chrono::steady_clock::now() - start >= 150ms);
+    TEST_EXPECT(fired_b == 0);
+    TEST_EXPECT(wheel.size() == 0);
+    // Kernel timeout is stopped once the wheel is empty
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    std::println("Arm and cancel completed");
+}
+
+struct on_fire {
+    std::size_t* fired;
+    std::size_t* early;
+    std::chrono::steady_clock::time_point deadline;
+
+    void operator()() const noexcept {
+        if (std::chrono::steady_clock::now() < deadline) {
+            ++*early;
+        }
+        ++*fired;
+    }
+};
+
+void test_many_timers() {
+    iouxx::ring ring(16);
+    iouxx::timer_wheel wheel(ring);
+    constexpr std::size_t total = 10000;
+    std::size_t fired = 0;
+    std::size_t early = 0;
+    std::vector<std::unique_ptr<iouxx::wheel_timer<on_fire>>> timers;
+    for (std::size_t i = 0; i < total; ++i) {
+        auto timeout = std::chrono::milliseconds(i % 97);
+        timers.push_back(std::make_unique<iouxx::wheel_timer<on_fire>>(on_fire{
+            &fired, &early, std::chrono::steady_clock::now() + timeout }));
+        TEST_EXPECT(!wheel.arm(*timers.back(), timeout));
+    }
+    TEST_EXPECT(wheel.size() == total);
+    // One kernel timeout for all of them, fired in batches per tick
+    TEST_EXPECT(!ring.run_until([&] { return fired == total; }));
+    TEST_EXPECT(early == 0);
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    std::println("Many timers completed");
+}
+
+void test_retarget() {
+    iouxx::ring ring(16);
+    iouxx::timer_wheel wheel(ring);
+    int fired_far = 0, fired_near = 0;
+    iouxx::wheel_timer far([&] noexcept { ++fired_far; });
+    iouxx::wheel_timer near([&] noexcept { ++fired_near; });
+    auto start = std::chrono::steady_clock::now();
+    TEST_EXPECT(!wheel.arm(far, 10s));
+    // Kernel timeout is moved earlier in place
+    TEST_EXPECT(!wheel.arm(near, 20ms));
+    TEST_EXPECT(!ring.run_until([&] { return fired_near == 1; }));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    TEST_EXPECT(elapsed >= 20ms && elapsed < 5s);
+    TEST_EXPECT(fired_far == 0);
+    TEST_EXPECT(far.armed());
+    TEST_EXPECT(wheel.running());
+    wheel.clear();
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    TEST_EXPECT(std::chrono::steady_clock::now() - start < 5s);
+    std::println("Retarget completed");
+}
+
+void test_clear() {
+    iouxx::ring ring(16);
+    iouxx::timer_wheel wheel(ring);
+    int fired = 0;
+    iouxx::wheel_timer a([&] noexcept { ++fired; });
+    iouxx::wheel_timer b([&] noexcept { ++fired; });
+    iouxx::wheel_timer c([&] noexcept { ++fired; });
+    TEST_EXPECT(!wheel.arm(a, 50ms));
+    TEST_EXPECT(!wheel.arm(b, 200ms));
+    TEST_EXPECT(!wheel.arm(c, 1h)); // Beyond the first levels
+    wheel.clear();
+    TEST_EXPECT(wheel.size() == 0);
+    TEST_EXPECT(!a.armed() && !b.armed() && !c.armed());
+    // Kernel timeout is cancelled rather than left to expire
+    auto start = std::chrono::steady_clock::now();
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    TEST_EXPECT(std::chrono::steady_clock::now() - start < 50ms);
+    TEST_EXPECT(fired == 0);
+    // Usable again afterwards
+    TEST_EXPECT(!wheel.arm(a, 5ms));
+    TEST_EXPECT(!ring.run_until([&] { return fired == 1; }));
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    std::println("Clear completed");
+}
+
+void test_idle_rearm() {
+    iouxx::ring ring(16);
+    iouxx::timer_wheel wheel(ring);
+    int fired = 0;
+    iouxx::wheel_timer t([&] noexcept { ++fired; });
+    TEST_EXPECT(!wheel.arm(t, 1ms));
+    TEST_EXPECT(!ring.run_until([&] { return fired == 1; }));
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    // Idle across several cascade boundaries of the first level
+    std::this_thread::sleep_for(200ms);
+    auto start = std::chrono::steady_clock::now();
+    TEST_EXPECT(!wheel.arm(t, 30ms));
+    // One kernel wakeup, at the deadline
+    std::size_t wakeups = 0;
+    while (fired != 2) {
+        auto reaped = ring.run_once();
+        TEST_EXPECT(reaped.has_value());
+        wakeups += *reaped;
+    }
+    TEST_EXPECT(std::chrono::steady_clock::now() - start >= 30ms);
+    TEST_EXPECT(wakeups == 1);
+    TEST_EXPECT(!ring.run_until([&] { return !wheel.running(); }));
+    std::println("Idle re-arm completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_arm_cancel();
+    test_many_timers();
+    test_retarget();
+    test_clear();
+    test_idle_rearm();
+}
@@ -0,0 +1,103 @@
+#ifdef IOUXX_CONFIG_USE_CXX_MODULE
+
+import std;
+import iouxx;
+
+#else // !IOUXX_CONFIG_USE_CXX_MODULE
+
+#include <chrono>
+#include <cstdlib>
+#include <print>
+#include <system_error>
+#include <tuple>
+
+#include "iouxx/iouringxx.hpp"
+#include "iouxx/task.hpp"
+#include "iouxx/iouops/noop.hpp"
+#include "iouxx/iouops/timeout.hpp"
+#include "iouxx/iouops/when.hpp"
+
+#endif // IOUXX_CONFIG_USE_CXX_MODULE
+
+#define TEST_EXPECT(...) do { \
+    if (!(__VA_ARGS__)) { \
+        std::println("Assertion failed: {}, {}:{}\n", #__VA_ARGS__, \
+        __FILE__, __LINE__); \
+        std::exit(-(__COUNTER__ + 1)); \
+    } \
+} while(0)
+
+using namespace std::literals;
+
+iouxx::detached_task all(iouxx::ring& ring, bool& done) {
+    auto noop = ring.make_await<iouxx::noop_operation>();
+    auto timer = ring.make_await<iouxx::timeout_operation>();
+    timer.wait_for(10ms);
+    auto start = std::chrono::steady_clock::now();
+    auto [n, t] = co_await iouxx::when_all(noop, timer);
+    TEST_EXPECT(n.has_value());
+    TEST_EXPECT(t.has_value());
+    // Resumed once, after the slowest one
+    TEST_EXPECT(std::chrono::steady_clock::now() - start >= 10ms);
+    done = true;
+}
+
+iouxx::detached_task any(iouxx::ring& ring, bool& done) {
+    auto fast = ring.make_await<iouxx::timeout_operation>();
+    auto slow = ring.make_await<iouxx::timeout_operation>();
+    fast.wait_for(10ms);
+    slow.wait_for(10s);
+    auto start = std::chrono::steady_clock::now();
+    auto res = co_await iouxx::when_any(slow, fast);
+    TEST_EXPECT(res.index == 1);
+    TEST_EXPECT(std::get<1>(res.results).has_value());
+    // Loser is cancelled in kernel rather than waited for
+    TEST_EXPECT(!std::get<0>(res.results));
+    TEST_EXPECT(std::get<0>(res.results).error() == std::errc::operation_canceled);
+    TEST_EXPECT(std::chrono::steady_clock::now() - start < 5s);
+    done = true;
+}
+
+iouxx::detached_task any_unsubmitted(iouxx::ring& ring, bool& done) {
+    auto a = ring.make_await<iouxx::noop_operation>();
+    auto b = ring.make_await<iouxx::noop_operation>();
+    // Batch does not fit in SQ of a single entry
+    auto res = co_await iouxx::when_any(a, b);
+    using result_type = decltype(res);
+    TEST_EXPECT(res.index == result_type::none);
+    TEST_EXPECT(std::get<0>(res.results).error() == std::errc::resource_unavailable_try_again);
+    TEST_EXPECT(std::get<1>(res.results).error() == std::errc::resource_unavailable_try_again);
+    done = true;
+}
+
+void test_when_all() {
+    iouxx::ring ring(8);
+    bool done = false;
+    all(ring, done).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done; }));
+    std::println("when_all completed");
+}
+
+void test_when_any() {
+    iouxx::ring ring(8, iouxx::ring_option().deferred_submit());
+    bool done = false;
+    any(ring, done).start();
+    TEST_EXPECT(!ring.run_until([&done] { return done; }));
+    std::println("when_any completed");
+}
+
+void test_when_any_unsubmitted() {
+    iouxx::ring ring(1);
+    bool done = false;
+    any_unsubmitted(ring, done).start();
+    // Resumed inline, nothing in flight
+    TEST_EXPECT(done);
+    std::println("when_any unsubmitted completed");
+}
+
+int main() {
+    TEST_EXPECT(true);
+    test_when_all();
+    test_when_any();
+    test_when_any_unsubmitted();
+}